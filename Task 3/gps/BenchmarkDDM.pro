@@ -0,0 +1,46 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors -O2
+
+HEADERS += \
+    headers/earth.h \
+    headers/geometry.h \
+    headers/logs.h \
+    headers/parseNMEA.h \
+    headers/points.h \
+    headers/position.h \
+    headers/positionBatch.h \
+    headers/types.h \
+    headers/nmea/byteScan.h \
+    headers/nmea/talkers.h \
+    headers/nmea/decodeQuery.h \
+    headers/nmea/expected.h \
+    headers/nmea/ingestStats.h \
+    headers/nmea/packedFormat.h \
+    headers/nmea/epochFusion.h
+
+SOURCES += \
+    apps/benchmarkDDM.cpp
+
+SOURCES += \
+    src/earth.cpp \
+    src/geometry.cpp \
+    src/logs.cpp \
+    src/parseNMEA.cpp \
+    src/position.cpp \
+    src/positionBatch.cpp \
+    src/nmea/byteScan.cpp \
+    src/nmea/talkers.cpp \
+    src/nmea/decodeQuery.cpp \
+    src/nmea/ingestStats.cpp \
+    src/nmea/epochFusion.cpp
+
+
+INCLUDEPATH += headers/ headers/nmea/
+
+OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
+DESTDIR = $$_PRO_FILE_PWD_/bin/
+TARGET = benchmark-ddm
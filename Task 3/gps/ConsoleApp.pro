@@ -1,11 +1,15 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
+CONFIG += link_pkgconfig
 
 QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
+    headers/compressedInput.h \
+    headers/batchDistance.h \
+    headers/distanceModel.h \
     headers/earth.h \
     headers/geometry.h \
     headers/logs.h \
@@ -22,6 +26,9 @@ SOURCES += \
     apps/consoleApp.cpp
 
 SOURCES += \
+    src/compressedInput.cpp \
+    src/batchDistance.cpp \
+    src/distanceModel.cpp \
     src/earth.cpp \
     src/geometry.cpp \
     src/logs.cpp \
@@ -35,6 +42,15 @@ SOURCES += \
 
 INCLUDEPATH += headers/ headers/xml/
 
+packagesExist(zlib) {
+    DEFINES += GPS_HAVE_ZLIB
+    PKGCONFIG += zlib
+}
+packagesExist(libzstd) {
+    DEFINES += GPS_HAVE_ZSTD
+    PKGCONFIG += libzstd
+}
+
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
 TARGET = console-app
@@ -1,11 +1,13 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
+CONFIG += link_pkgconfig
 
 QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
+    headers/compressedInput.h \
     headers/earth.h \
     headers/geometry.h \
     headers/logs.h \
@@ -16,6 +18,7 @@ HEADERS += \
     headers/xml/parser.h
 
 SOURCES += \
+    src/compressedInput.cpp \
     src/earth.cpp \
     src/geometry.cpp \
     src/logs.cpp \
@@ -28,10 +31,20 @@ SOURCES += \
     tests/gpx/parseGPX-tests.cpp \
     tests/gpx/parseRoute-tests.cpp \
     tests/gpx/parseTrack-tests.cpp \
+    tests/gpx/compressedGPX-tests.cpp \
     tests/xml/parser-tests.cpp
 
 INCLUDEPATH += headers/ headers/xml/
 
+packagesExist(zlib) {
+    DEFINES += GPS_HAVE_ZLIB
+    PKGCONFIG += zlib
+}
+packagesExist(libzstd) {
+    DEFINES += GPS_HAVE_ZSTD
+    PKGCONFIG += libzstd
+}
+
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
 TARGET = parseGPX-tests
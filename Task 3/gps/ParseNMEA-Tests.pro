@@ -1,29 +1,96 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
+CONFIG += link_pkgconfig
 
 QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
+    headers/compressedInput.h \
+    headers/batchDistance.h \
+    headers/distanceModel.h \
     headers/earth.h \
     headers/geometry.h \
     headers/logs.h \
     headers/parseNMEA.h \
+    headers/points.h \
     headers/position.h \
-    headers/types.h
+    headers/positionBatch.h \
+    headers/route.h \
+    headers/track.h \
+    headers/types.h \
+    headers/nmea/byteScan.h \
+    headers/nmea/talkers.h \
+    headers/nmea/mappedFile.h \
+    headers/nmea/streamDecoder.h \
+    headers/nmea/decodeQuery.h \
+    headers/nmea/expected.h \
+    headers/nmea/epochFusion.h \
+    headers/nmea/ingestStats.h \
+    headers/nmea/packedFormat.h \
+    headers/nmea/positionCache.h \
+    headers/nmea/multiLog.h \
+    headers/nmea/resyncScanner.h \
+    headers/nmea/timeIndex.h
 
 SOURCES += \
+    src/compressedInput.cpp \
+    src/batchDistance.cpp \
+    src/distanceModel.cpp \
     src/earth.cpp \
     src/geometry.cpp \
     src/logs.cpp \
     src/parseNMEA.cpp \
     src/position.cpp \
+    src/positionBatch.cpp \
+    src/route.cpp \
+    src/track.cpp \
+    src/nmea/byteScan.cpp \
+    src/nmea/talkers.cpp \
+    src/nmea/mappedFile.cpp \
+    src/nmea/parallelLog.cpp \
+    src/nmea/streamDecoder.cpp \
+    src/nmea/epochFusion.cpp \
+    src/nmea/decodeQuery.cpp \
+    src/nmea/ingestStats.cpp \
+    src/nmea/positionCache.cpp \
+    src/nmea/multiLog.cpp \
+    src/nmea/resyncScanner.cpp \
+    src/nmea/timeIndex.cpp
     
 SOURCES += \
-    tests/parseNMEA-tests.cpp
+    tests/parseNMEA-tests.cpp \
+    tests/nmea/sentenceView-tests.cpp \
+    tests/nmea/scanSentence-tests.cpp \
+    tests/nmea/byteScan-tests.cpp \
+    tests/nmea/parallelLog-tests.cpp \
+    tests/nmea/streamDecoder-tests.cpp \
+    tests/nmea/parseDecimal-tests.cpp \
+    tests/nmea/formatDispatch-tests.cpp \
+    tests/nmea/talkers-tests.cpp \
+    tests/nmea/tryInterpret-tests.cpp \
+    tests/nmea/positionBatch-tests.cpp \
+    tests/nmea/trackPoints-tests.cpp \
+    tests/nmea/epochFusion-tests.cpp \
+    tests/nmea/ingestStats-tests.cpp \
+    tests/nmea/positionCache-tests.cpp \
+    tests/nmea/compressedInput-tests.cpp \
+    tests/nmea/multiLog-tests.cpp \
+    tests/nmea/decodeQuery-tests.cpp \
+    tests/nmea/resyncScanner-tests.cpp \
+    tests/nmea/timeIndex-tests.cpp
 
-INCLUDEPATH += headers/
+INCLUDEPATH += headers/ headers/nmea/
+
+packagesExist(zlib) {
+    DEFINES += GPS_HAVE_ZLIB
+    PKGCONFIG += zlib
+}
+packagesExist(libzstd) {
+    DEFINES += GPS_HAVE_ZSTD
+    PKGCONFIG += libzstd
+}
 
 OBJECTS_DIR = $$_PRO_FILE_PWD_/bin/
 DESTDIR = $$_PRO_FILE_PWD_/bin/
@@ -6,6 +6,8 @@ CONFIG -= qt
 QMAKE_CXXFLAGS += -std=c++17 -Wall -Wfatal-errors
 
 HEADERS += \
+    headers/batchDistance.h \
+    headers/distanceModel.h \
     headers/earth.h \
     headers/geometry.h \
     headers/logs.h \
@@ -21,6 +23,8 @@ HEADERS += \
     headers/xml/generator.h
 
 SOURCES += \
+    src/batchDistance.cpp \
+    src/distanceModel.cpp \
     src/earth.cpp \
     src/geometry.cpp \
     src/logs.cpp \
@@ -37,7 +41,12 @@ SOURCES += \
     tests/route/route-tests.cpp \
     tests/route/numpoints.cpp \
     tests/route/indexing.cpp \
-    tests/route/findposition.cpp
+    tests/route/findposition.cpp \
+    tests/route/batchdistance.cpp \
+    tests/route/preparedposition.cpp \
+    tests/route/distancemodels.cpp \
+    tests/route/trig.cpp \
+    tests/route/constants.cpp
 
 INCLUDEPATH += headers/ headers/xml/ headers/gridworld
 
@@ -0,0 +1,78 @@
+/* Microbenchmark comparing ddmTodd() (std::stod on a std::string) with parseDDM()
+ * (parseDecimal on a std::string_view), over every coordinate field in the NMEA logs.
+ *
+ * Run from the 'bin/' directory, so that the logs can be found.
+ */
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "position.h"
+#include "parseNMEA.h"
+
+using namespace GPS;
+
+namespace
+{
+  const int repetitions = 200;
+
+  std::vector<std::string> coordinateFieldsFromLogs()
+  {
+      std::vector<std::string> fields;
+      for (const std::string filename : {"gll.log", "gga_rmc-1.log", "gga_rmc-2.log"})
+      {
+          std::ifstream log{LogFiles::NMEALogsDir + filename};
+          if (! log.good()) throw std::invalid_argument("Could not open log file: " + LogFiles::NMEALogsDir + filename);
+
+          std::string line;
+          while (std::getline(log, line))
+          {
+              if (! NMEA::isWellFormedSentence(line)) continue;
+              for (const std::string & field : NMEA::parseSentenceData(line).dataFields)
+              {
+                  if (field.find('.') != std::string::npos && field.find_first_not_of("0123456789.") == std::string::npos)
+                  {
+                      fields.push_back(field);
+                  }
+              }
+          }
+      }
+      return fields;
+  }
+
+  // Returns the mean time per conversion, in nanoseconds.
+  template <typename Converter>
+  double timeConversions(const std::vector<std::string> & fields, Converter convert, double & checksum)
+  {
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < repetitions; ++i)
+      {
+          for (const std::string & field : fields) checksum += convert(field);
+      }
+      const auto finish = std::chrono::steady_clock::now();
+      const double totalNanoseconds = std::chrono::duration<double,std::nano>(finish - start).count();
+      return totalNanoseconds / (repetitions * fields.size());
+  }
+}
+
+int main()
+{
+    const std::vector<std::string> fields = coordinateFieldsFromLogs();
+
+    // Printed so that the conversions cannot be optimised away.
+    double stodChecksum = 0, parseChecksum = 0;
+
+    const double stodTime = timeConversions(fields, [](const std::string & field) { return ddmTodd(field); }, stodChecksum);
+    const double parseTime = timeConversions(fields, [](std::string_view field) { return parseDDM(field); }, parseChecksum);
+
+    std::cout << "Fields converted:          " << fields.size() << " x " << repetitions << std::endl;
+    std::cout << "ddmTodd()  (std::stod):    " << stodTime << " ns/field" << std::endl;
+    std::cout << "parseDDM() (parseDecimal): " << parseTime << " ns/field" << std::endl;
+    std::cout << "Speed-up:                  " << stodTime / parseTime << "x" << std::endl;
+    std::cout << "Results identical:         " << (stodChecksum == parseChecksum ? "yes" : "NO") << std::endl;
+
+    return stodChecksum == parseChecksum ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#ifndef BATCHDISTANCE_H_261016
+#define BATCHDISTANCE_H_261016
+
+#include <cstddef>
+#include <vector>
+
+#include "types.h"
+#include "position.h"
+
+namespace GPS
+{
+  /* Batch versions of Position::horizontalDistanceBetween(), for computing many
+   * haversine distances at once.  There is a portable scalar implementation, which
+   * gives exactly the same results as Position::horizontalDistanceBetween(), along
+   * with AVX2 and AVX-512 implementations (processing 4 and 8 pairs at a time) on x86
+   * processors that support them.
+   *
+   * The SIMD implementations evaluate sin, cos and asin using more terms of the Trig
+   * series in geometry.h, with their own argument reductions, so their results differ
+   * slightly from the scalar ones.  Compared to the scalar implementation, the SIMD
+   * error is bounded by:
+   *   - a relative error of 5e-13 (i.e. at most 10 micrometres over 20000 km) for
+   *     distances up to 19000 km;
+   *   - an absolute error of 0.01 metres for nearly antipodal points (beyond 19000 km),
+   *     where asin() is ill-conditioned and the scalar result is no more accurate.
+   * Both bounds are checked by the tests.
+   *
+   * Latitudes must be in the range [-90,90], as enforced by the Position class.
+   */
+  namespace BatchDistance
+  {
+      struct Kernels
+      {
+          // The instruction set used, e.g. "scalar", "AVX2" or "AVX-512".
+          const char * name;
+
+          /* Computes the horizontal distance between the points (lat1[i],lon1[i]) and
+           * (lat2[i],lon2[i]), for each i from 0 to n-1, storing the result in out[i].
+           */
+          void (*pairwise)(const degrees * lat1, const degrees * lon1,
+                           const degrees * lat2, const degrees * lon2,
+                           metres * out, std::size_t n);
+      };
+
+      // The portable implementation, always available.
+      const Kernels & scalarKernels();
+
+      // All the implementations supported by the current CPU, starting with the scalar one.
+      std::vector<const Kernels *> availableKernels();
+
+      /* The fastest implementation supported by the current CPU.
+       * This is chosen on first use, by querying the CPU at run-time.
+       */
+      const Kernels & bestKernels();
+
+      // Dispatches to the bestKernels() implementation.
+      void horizontalDistances(const degrees * lat1, const degrees * lon1,
+                               const degrees * lat2, const degrees * lon2,
+                               metres * out, std::size_t n);
+
+      /* Computes the horizontal distances between successive points of an array of
+       * n points, storing the n-1 results in out (nothing is stored if n < 2).
+       */
+      void consecutiveDistances(const degrees * lats, const degrees * lons, metres * out, std::size_t n);
+
+      // The horizontal distances between successive Positions (one fewer than the number of Positions).
+      std::vector<metres> consecutiveDistances(const std::vector<Position> &);
+  }
+}
+
+#endif
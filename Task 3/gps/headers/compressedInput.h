@@ -0,0 +1,66 @@
+#ifndef COMPRESSEDINPUT_H_261016
+#define COMPRESSEDINPUT_H_261016
+
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace GPS
+{
+  enum class Compression { none, gzip, zstd };
+
+
+  /* Identifies the compression format from the leading bytes of a file, using the
+   * gzip and zstd "magic numbers".  At least 4 bytes are needed to recognise zstd.
+   */
+  Compression detectCompression(std::string_view leadingBytes);
+
+
+  /* As above, but reads the leading bytes of the named file.  FIFOs and devices cannot
+   * be read twice, so they are not read, and are taken to be uncompressed.
+   * Throws a std::invalid_argument exception if the file cannot be opened.
+   */
+  Compression compressionOf(const std::string & filePath);
+
+
+  /* Determine whether this build can decompress a format.
+   * gzip is supported if the library was built with zlib (GPS_HAVE_ZLIB), and zstd if
+   * it was built with libzstd (GPS_HAVE_ZSTD).
+   */
+  bool canDecompress(Compression);
+
+
+  /* An input stream over the contents of a file, which is transparently decompressed if
+   * it is gzip or zstd compressed.  The format is detected from the file's magic bytes,
+   * not its name.
+   *
+   * Compressed files are decompressed on a background thread, which works up to a few
+   * blocks ahead of the reader, so that decompression overlaps with parsing.
+   *
+   * Throws a std::invalid_argument exception if the file cannot be opened, or a
+   * std::domain_error exception if it is compressed in a format that this build cannot
+   * decompress.
+   */
+  class InputFile : public std::istream
+  {
+    public:
+      explicit InputFile(const std::string & filePath);
+      ~InputFile();
+
+      Compression compression() const;
+
+      /* Corrupt or truncated compressed data ends the stream early.  Call this after
+       * reaching the end of the stream to find out whether that happened; it throws a
+       * std::domain_error exception if so.
+       */
+      void checkDecompression() const;
+
+    private:
+      Compression format;
+      std::unique_ptr<std::streambuf> buffer;
+  };
+}
+
+#endif
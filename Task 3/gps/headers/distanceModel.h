@@ -0,0 +1,64 @@
+#ifndef DISTANCEMODEL_H_261016
+#define DISTANCEMODEL_H_261016
+
+#include <cstddef>
+
+#include "types.h"
+#include "position.h"
+
+namespace GPS
+{
+  /* A way of computing the horizontal distance between two Positions, trading accuracy
+   * for speed.  Routes and Tracks are built with a DistanceModel, which they then use for
+   * all their distance calculations.  The available models are in DistanceModels below.
+   */
+  struct DistanceModel
+  {
+      // The name of the model, e.g. "haversine".
+      const char * name;
+
+      // The horizontal distance between two Positions.
+      metres (*horizontalDistanceBetween)(const PreparedPosition &, const PreparedPosition &);
+
+      /* A batch version of the above: computes the horizontal distance between the points
+       * (lat1[i],lon1[i]) and (lat2[i],lon2[i]), for each i from 0 to n-1, storing the result
+       * in out[i].  This is a null pointer for models without a batch implementation.
+       */
+      void (*horizontalDistances)(const degrees * lat1, const degrees * lon1,
+                                  const degrees * lat2, const degrees * lon2,
+                                  metres * out, std::size_t n);
+  };
+
+  namespace DistanceModels
+  {
+      /* The great-circle distance on a sphere of radius Earth::meanRadius, as given by
+       * Position::horizontalDistanceBetween().  Batches use BatchDistance::horizontalDistances().
+       * Compared to the WGS84 ellipsoid, the relative error is at most 0.6%.
+       */
+      const DistanceModel & haversine();
+
+      /* Pythagoras on an equirectangular projection, using the mean of the cosines of the
+       * two latitudes to scale the longitude difference.  This needs no trig functions
+       * given PreparedPositions, just a square root.
+       * Compared to haversine(), for segments up to 10 km long and latitudes within 80
+       * degrees of the equator, the relative error is at most 0.001%.
+       */
+      const DistanceModel & equirectangular();
+
+      /* Pythagoras on the plane tangent to the Earth at the first Position.  This is the
+       * cheapest model, but it is not symmetric.
+       * Compared to haversine(), for segments up to 10 km long and latitudes within 80
+       * degrees of the equator, the relative error is at most 0.2%.
+       */
+      const DistanceModel & flatEarth();
+
+      /* The geodesic distance on the WGS84 ellipsoid, using Vincenty's inverse formula.
+       * This is accurate to 0.5 mm, but is several times slower than haversine().
+       * If the iteration fails to converge, which can only happen for nearly antipodal
+       * points, the haversine() distance is returned instead (so within 0.6% there).
+       */
+      const DistanceModel & vincenty();
+  }
+}
+
+#endif
@@ -1,27 +1,35 @@
 #ifndef EARTH_H_120218
 #define EARTH_H_120218
 
+#include "geometry.h"
 #include "position.h"
 
 namespace GPS
 {
   namespace Earth
   {
-      extern const Position NorthPole;
-      extern const Position EquatorialMeridian;
-      extern const Position EquatorialAntiMeridian;
-      extern const Position CliftonCampus;
-      extern const Position CityCampus;
-      extern const Position Pontianak;
+      inline constexpr Position NorthPole = Position(poleLatitude,0,0);
+      inline constexpr Position EquatorialMeridian = Position(0,0,0);
+      inline constexpr Position EquatorialAntiMeridian = Position(0,antiMeridianLongitude,0);
+      inline constexpr Position CliftonCampus = Position(52.91249953,-1.18402513,58);
+      inline constexpr Position CityCampus = Position(52.9581383,-1.1542364,53);
+      inline constexpr Position Pontianak = Position(0,109.322134,0);
 
-      extern const metres meanRadius;
-      extern const metres equatorialCircumference;
-      extern const metres polarCircumference;
+      inline constexpr metres meanRadius = 6371008.8;
+      inline constexpr metres equatorialCircumference = 40075160;
+      inline constexpr metres polarCircumference = 40008000;
+
+      // The WGS84 reference ellipsoid, used by GPS.
+      inline constexpr metres wgs84SemiMajorAxis = 6378137;
+      inline constexpr double wgs84Flattening = 1/298.257223563;
+
+      constexpr degrees latitudeSubtendedBy(metres distance)
+      {
+          return (distance / polarCircumference) * fullRotation;
+      }
 
-      degrees latitudeSubtendedBy(metres);
       degrees longitudeSubtendedBy(metres,degrees lat);
   }
 }
 
 #endif
-
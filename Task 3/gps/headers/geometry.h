@@ -1,33 +1,189 @@
 #ifndef GEOMETRY_H_211217
 #define GEOMETRY_H_211217
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
 #include "types.h"
 
 namespace GPS
 {
-  extern const double pi;
-  extern const degrees fullRotation;
-  extern const degrees halfRotation;
-  extern const degrees poleLatitude;
-  extern const degrees antiMeridianLongitude;
+  /* These are constexpr, rather than defined in geometry.cpp, so that expressions using
+   * them (including constant Positions) can be evaluated at compile time.
+   */
+  inline constexpr double pi = 3.141592653589793;
+  inline constexpr degrees fullRotation = 360;
+  inline constexpr degrees halfRotation = fullRotation/2;
+  inline constexpr degrees poleLatitude = fullRotation/4;
+  inline constexpr degrees antiMeridianLongitude = fullRotation/2;
 
   // Compute hypotenuse of right-angled triangle in two dimensions.
-  double pythagoras(double,double);
+  inline double pythagoras(double x, double y)
+  {
+      return std::sqrt(x*x + y*y);
+  }
 
   // Compute hypotenuse of right-angled triangle in three dimensions.
-  double pythagoras(double,double,double);
+  inline double pythagoras(double x, double y, double z)
+  {
+      return std::sqrt(x*x + y*y + z*z);
+  }
 
   // Convert from degrees to radians.
-  radians degToRad(degrees);
+  constexpr radians degToRad(degrees d)
+  {
+      return d * pi / halfRotation;
+  }
 
   // Convert from radians to degrees.
-  radians radToDeg(degrees);
-
-  // Sine squared function: sin^2(x)
-  double sinSqr(radians);
+  constexpr degrees radToDeg(radians r)
+  {
+      return r * halfRotation / pi;
+  }
 
   // Ensure degrees are in (-180,180] range.
   degrees normaliseDeg(degrees);
+
+
+  /* Polynomial approximations of sin, cos, asin and atan, which are much faster than the
+   * standard library functions.  They are inline, and have no branches other than choices
+   * between two values, so that loops using them can be auto-vectorised.
+   *
+   * They come in two precision tiers, with maximum absolute errors (compared to the
+   * standard library) of:
+   *   - Trig::Precision::low  : 1e-7
+   *   - Trig::Precision::high : 1e-12
+   * sin, asin and atan are computed as x times a polynomial in x^2, so their relative
+   * errors are similarly small close to zero.
+   *
+   * sin and cos reduce their argument modulo pi/2, and are accurate for |x| up to 1e6.
+   */
+  namespace Trig
+  {
+      enum class Precision { low, high };
+
+      /* Taylor series coefficients of x^2k in sin(x)/x, cos(x), asin(x)/x and atan(x)/x.
+       * Each tier uses the number of terms that gives its error bound on the reduced
+       * argument range of the function.  The SIMD kernels in batchDistance.cpp use more
+       * terms of sin and cos than either tier.
+       */
+      inline constexpr double sinTerms[] = {
+          1.0, -0.16666666666666666, 0.008333333333333333, -0.0001984126984126984,
+          2.7557319223985893e-06, -2.505210838544172e-08, 1.6059043836821613e-10, -7.647163731819816e-13,
+          2.8114572543455206e-15, -8.22063524662433e-18 };
+      inline constexpr double cosTerms[] = {
+          1.0, -0.5, 0.041666666666666664, -0.001388888888888889, 2.48015873015873e-05,
+          -2.755731922398589e-07, 2.08767569878681e-09, -1.1470745597729725e-11,
+          4.779477332387385e-14, -1.5619206968586225e-16 };
+      inline constexpr double asinTerms[] = {
+          1.0, 0.16666666666666666, 0.075, 0.044642857142857144, 0.030381944444444444,
+          0.022372159090909092, 0.017352764423076924, 0.01396484375, 0.011551800896139705,
+          0.009761609529194078, 0.008390335809616815, 0.0073125258735988454,
+          0.006447210311889649, 0.005740037670841924, 0.005153309682319905,
+          0.004660143486915096, 0.004240907093679363, 0.003880964558837669 };
+      inline constexpr double atanTerms[] = {
+          1.0, -0.3333333333333333, 0.2, -0.14285714285714285, 0.1111111111111111,
+          -0.09090909090909091, 0.07692307692307693, -0.06666666666666667,
+          0.058823529411764705, -0.05263157894736842, 0.047619047619047616,
+          -0.043478260869565216, 0.04, -0.037037037037037035, 0.034482758620689655 };
+
+      template <Precision P> struct TermCounts;
+      template <> struct TermCounts<Precision::low>  { static constexpr std::size_t sin = 5, cos = 5, asin = 10, atan = 8; };
+      template <> struct TermCounts<Precision::high> { static constexpr std::size_t sin = 8, cos = 8, asin = 18, atan = 15; };
+
+      // Horner's method for the first N coefficients.
+      template <std::size_t N>
+      inline double polynomial(double x, const double * coefficients)
+      {
+          double result = coefficients[N-1];
+          for (std::size_t i = N-1; i-- > 0; )
+          {
+              result = result * x + coefficients[i];
+          }
+          return result;
+      }
+
+      /* Reduces x to r in [-pi/4,pi/4], where x = r + n*pi/2, also returning n mod 4.
+       * Adding 1.5*2^52 rounds to the nearest integer, leaving n in the low bits.  pi/2 is
+       * split into a 33 bit part, for which n*pi/2 is exact, and the remainder.
+       */
+      inline radians reduce(radians x, unsigned int & quadrant)
+      {
+          const double roundingShift = 6755399441055744.0;
+          const double shifted = x * 0.6366197723675814 + roundingShift;
+          std::uint64_t bits;
+          std::memcpy(&bits, &shifted, sizeof(bits));
+          quadrant = static_cast<unsigned int>(bits) & 3;
+          const double n = shifted - roundingShift;
+          return (x - n * 1.5707963267341256) - n * 6.077100506506192e-11;
+      }
+
+      template <Precision P>
+      inline double sin(radians x)
+      {
+          unsigned int quadrant;
+          const radians r = reduce(x, quadrant);
+          const double r2 = r * r;
+          const double sinR = r * polynomial<TermCounts<P>::sin>(r2, sinTerms);
+          const double cosR = polynomial<TermCounts<P>::cos>(r2, cosTerms);
+          const double result = (quadrant & 1) ? cosR : sinR;
+          return (quadrant & 2) ? -result : result;
+      }
+
+      template <Precision P>
+      inline double cos(radians x)
+      {
+          unsigned int quadrant;
+          const radians r = reduce(x, quadrant);
+          const double r2 = r * r;
+          const double sinR = r * polynomial<TermCounts<P>::sin>(r2, sinTerms);
+          const double cosR = polynomial<TermCounts<P>::cos>(r2, cosTerms);
+          const double result = (quadrant & 1) ? sinR : cosR;
+          return ((quadrant + 1) & 2) ? -result : result;
+      }
+
+      // Uses asin(x) = pi/2 - 2 asin(sqrt((1-x)/2)) for x > 1/2.
+      template <Precision P>
+      inline radians asin(double x)
+      {
+          const double a = std::abs(x);
+          const bool large = a > 0.5;
+          const double t = large ? std::sqrt((1 - a) / 2) : a;
+          const radians asinT = t * polynomial<TermCounts<P>::asin>(t * t, asinTerms);
+          return std::copysign(large ? 1.5707963267948966 - 2 * asinT : asinT, x);
+      }
+
+      /* Uses atan(x) = pi/2 - atan(1/x) for x > 1, and then
+       * atan(x) = pi/4 + atan((x-1)/(x+1)) for x > tan(pi/8).
+       */
+      template <Precision P>
+      inline radians atan(double x)
+      {
+          const double a = std::abs(x);
+          const bool inverted = a > 1;
+          const double b = inverted ? 1 / a : a;
+          const bool shifted = b > 0.41421356237309503;
+          const double z = shifted ? (b - 1) / (b + 1) : b;
+          radians result = z * polynomial<TermCounts<P>::atan>(z * z, atanTerms);
+          result = shifted ? 0.7853981633974483 + result : result;
+          result = inverted ? 1.5707963267948966 - result : result;
+          return std::copysign(result, x);
+      }
+  }
+
+  /* The precision tier used by sinSqr(), Position::horizontalDistanceBetween() and the
+   * Route gradient functions.
+   */
+  constexpr Trig::Precision trigPrecision = Trig::Precision::high;
+
+  // Sine squared function: sin^2(x)
+  inline double sinSqr(radians x)
+  {
+      const double sx = Trig::sin<trigPrecision>(x);
+      return sx * sx;
+  }
 }
 
 #endif
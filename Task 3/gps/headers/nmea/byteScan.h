@@ -0,0 +1,63 @@
+#ifndef BYTESCAN_H_261016
+#define BYTESCAN_H_261016
+
+#include <cstddef>
+#include <vector>
+
+namespace NMEA
+{
+  /* Low-level byte scanning kernels used when validating and tokenising NMEA sentences.
+   * Each kernel has a portable scalar implementation, along with SSE2 and AVX2
+   * implementations (processing 16 and 32 bytes at a time) on x86 processors that
+   * support them.  All implementations return identical results.
+   */
+  namespace ByteScan
+  {
+      // The characters that findDelimiter() searches for.
+      const char fieldDelimiter = ',';
+      const char checksumDelimiter = '*';
+      const char sentenceStart = '$';
+      const char lineEnd = '\n';
+
+      struct Kernels
+      {
+          // The instruction set used, e.g. "scalar", "SSE2" or "AVX2".
+          const char * name;
+
+          // The XOR reduction of all the bytes in a buffer (zero for an empty buffer).
+          unsigned char (*xorReduce)(const char *, std::size_t);
+
+          /* The offset of the first ',', '*', '$' or '\n' character in a buffer, or the
+           * length of the buffer if there is none.
+           */
+          std::size_t (*findDelimiter)(const char *, std::size_t);
+
+          /* As findDelimiter(), but also XORs the bytes before the delimiter into the last
+           * parameter, reading each byte only once.
+           */
+          std::size_t (*findDelimiterXor)(const char *, std::size_t, unsigned char &);
+      };
+
+      // The portable implementation, always available.
+      const Kernels & scalarKernels();
+
+      // All the implementations supported by the current CPU, starting with the scalar one.
+      std::vector<const Kernels *> availableKernels();
+
+      /* The fastest implementation supported by the current CPU.
+       * This is chosen on first use, by querying the CPU at run-time.
+       */
+      const Kernels & bestKernels();
+
+      // Dispatches to the bestKernels() implementation.
+      unsigned char xorReduce(const char *, std::size_t);
+
+      // Dispatches to the bestKernels() implementation.
+      std::size_t findDelimiter(const char *, std::size_t);
+
+      // Dispatches to the bestKernels() implementation.
+      std::size_t findDelimiterXor(const char *, std::size_t, unsigned char &);
+  }
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef DECODEQUERY_H_261016
+#define DECODEQUERY_H_261016
+
+#include <cstdint>
+#include <limits>
+
+#include "types.h"
+
+namespace NMEA
+{
+  /* Describes which outputs a caller needs from decoding a log (a projection), and which
+   * sentences it wants (predicates), so that decoding can skip the rest.
+   *
+   * Each predicate is checked as soon as the fields it depends on have been decoded, and
+   * in order of cost: the fix quality (a single character), then the time of day, then
+   * the bounding box (once both coordinates have been decoded and validated, so that an
+   * invalid sentence is never counted as filtered).  A sentence that fails a predicate is
+   * dropped without decoding any further fields.
+   *
+   * The default DecodeQuery accepts every sentence and decodes every output.
+   */
+  struct DecodeQuery
+  {
+      /* Whether to decode elevations.  If not, Positions have zero elevation, and the
+       * elevation field is neither decoded nor validated.
+       */
+      bool elevations = true;
+
+      /* The range of UTC times of day to accept, in seconds since midnight (inclusive).
+       * If the range is restricted, sentences without a valid time are dropped.
+       */
+      double earliestTime = -std::numeric_limits<double>::infinity();
+      double latestTime = std::numeric_limits<double>::infinity();
+
+      /* The bounding box to accept (inclusive).  If 'minLongitude' exceeds 'maxLongitude',
+       * the box crosses the anti-meridian.
+       */
+      GPS::degrees minLatitude = -90;
+      GPS::degrees maxLatitude = 90;
+      GPS::degrees minLongitude = -180;
+      GPS::degrees maxLongitude = 180;
+
+      /* The minimum fix quality to accept, as returned by fixQuality() (e.g. 1 for a GPS
+       * fix).  If non-zero, sentences with an unknown fix quality are dropped.
+       */
+      std::uint8_t minFixQuality = 0;
+
+      bool restrictsTime() const;
+      bool acceptsTime(double timeOfDay) const;
+      bool acceptsLatitude(GPS::degrees) const;
+      bool acceptsLongitude(GPS::degrees) const;
+      bool acceptsFixQuality(std::uint8_t) const;
+  };
+}
+
+#endif
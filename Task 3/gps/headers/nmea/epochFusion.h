@@ -0,0 +1,76 @@
+#ifndef EPOCHFUSION_H_261016
+#define EPOCHFUSION_H_261016
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <vector>
+
+#include "types.h"
+#include "position.h"
+#include "parseNMEA.h"
+
+namespace NMEA
+{
+  /* A fix merged from all of the sentences that report the same epoch (UTC time).
+   */
+  struct Fix
+  {
+      // The elevation is only meaningful if 'hasElevation' is set.
+      GPS::Position position;
+      bool hasElevation;
+
+      double timeOfDay; // seconds since midnight, UTC; NaN if unknown
+
+      std::uint8_t fixQuality; // as NMEA::fixQuality()
+
+      // From RMC sentences.
+      std::optional<std::tm> date;
+      std::optional<GPS::speed> groundSpeed;
+      std::optional<GPS::degrees> course;
+  };
+
+
+  /* Merges consecutive sentences that share a UTC time into a single Fix, such as the
+   * GGA and RMC sentences that most receivers emit for every epoch.
+   *
+   * The position (with its elevation) is taken from a GGA sentence if there is one,
+   * and the date, speed and course from an RMC sentence.  The fix quality is taken from
+   * the first sentence that reports one, preferring GGA's fix quality field.
+   *
+   * Sentences are fed one at a time, and each Fix is passed to a callback as soon as a
+   * sentence from a later epoch arrives (or at finish()), so only one Fix is buffered.
+   * Sentences without a valid time cannot be merged, so each becomes a Fix on its own.
+   */
+  class EpochFusion
+  {
+    public:
+      using FixHandler = std::function<void(const Fix &)>;
+
+      explicit EpochFusion(FixHandler);
+
+      /* Adds a sentence (which must be supported), along with the Position that
+       * interpretSentenceData() computed from it.
+       */
+      void add(const SentenceView &, const GPS::Position &);
+
+      // Passes on the Fix for the final epoch, if any.
+      void finish();
+
+    private:
+      FixHandler handleFix;
+
+      std::optional<Fix> pending;
+  };
+
+
+  /* As positionsFromLog(), but merges the sentences of each epoch, as by EpochFusion.
+   */
+  std::vector<Fix> fixesFromLog(std::istream &);
+
+  std::vector<Fix> fixesFromLog(std::istream &, const TalkerSet &, TalkerCounts * = nullptr);
+}
+
+#endif
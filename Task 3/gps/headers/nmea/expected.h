@@ -0,0 +1,60 @@
+#ifndef EXPECTED_H_261016
+#define EXPECTED_H_261016
+
+#include <stdexcept>
+#include <variant>
+
+namespace NMEA
+{
+  /* Holds either a value, or an error code explaining why there is no value.
+   * This allows failures to be reported without the cost of throwing an exception,
+   * in the style of C++23's std::expected.
+   */
+  template <typename Value, typename Error>
+  class Expected
+  {
+    public:
+      Expected(const Value & value) : contents(value) {}
+      Expected(Error error) : contents(error) {}
+
+      bool hasValue() const
+      {
+          return contents.index() == 0;
+      }
+
+      explicit operator bool() const
+      {
+          return hasValue();
+      }
+
+      // Throws a std::logic_error exception if there is no value.
+      const Value & value() const
+      {
+          if (! hasValue()) throw std::logic_error("No value present.");
+          return std::get<0>(contents);
+      }
+
+      // Pre-condition: there is no value.
+      Error error() const
+      {
+          return std::get<1>(contents);
+      }
+
+      // Pre-condition: there is a value.
+      const Value & operator*() const
+      {
+          return *std::get_if<0>(&contents);
+      }
+
+      // Pre-condition: there is a value.
+      const Value * operator->() const
+      {
+          return std::get_if<0>(&contents);
+      }
+
+    private:
+      std::variant<Value,Error> contents;
+  };
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef INGESTSTATS_H_261016
+#define INGESTSTATS_H_261016
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace NMEA
+{
+  /* Statistics describing the decoding of a log or stream: how much input was read,
+   * how many sentences of each format were accepted, why the other lines were rejected,
+   * and how long the decoding took.
+   *
+   * Recording a line is a few integer increments, so statistics are always collected;
+   * callers that do not want them simply do not ask for them.
+   */
+  struct IngestStats
+  {
+      // The number of lines read, and of bytes read (including line breaks).
+      std::uint64_t linesRead = 0;
+      std::uint64_t bytesRead = 0;
+
+      // The number of lines rejected for each reason.
+      std::uint64_t malformed = 0;         // not a well-formed sentence (or an unaccepted talker ID)
+      std::uint64_t badChecksum = 0;       // well-formed, but with an incorrect checksum
+      std::uint64_t unsupportedFormat = 0; // a sentence format that cannot be decoded
+      std::uint64_t invalidFields = 0;     // missing or invalid data fields
+
+      // The number of valid sentences excluded by a DecodeQuery; these are not rejections.
+      std::uint64_t filtered = 0;
+
+      // The time spent decoding.
+      std::chrono::nanoseconds elapsed = std::chrono::nanoseconds::zero();
+
+      // Counts an accepted sentence of the specified (three-letter) format.
+      void addAccepted(std::string_view format);
+
+      // The number of sentences of the specified format accepted.
+      std::uint64_t accepted(std::string_view format) const;
+
+      // The number of sentences accepted, over all formats.
+      std::uint64_t accepted() const;
+
+      // The number of lines rejected, for any reason.
+      std::uint64_t rejected() const;
+
+      /* Throughput over the elapsed time.
+       * Returns zero if no time has elapsed.
+       */
+      double linesPerSecond() const;
+      double bytesPerSecond() const;
+
+      IngestStats & operator+=(const IngestStats &);
+
+    private:
+      // Enough for all the supported formats; any others are counted only in the total.
+      static const std::size_t maxFormats = 8;
+
+      std::array<std::uint32_t,maxFormats> formats = {}; // packed format codes; zero if unused
+      std::array<std::uint64_t,maxFormats> formatCounts = {};
+      std::uint64_t otherFormatCount = 0;
+
+      void addAccepted(std::uint32_t packedFormat, std::uint64_t count);
+  };
+}
+
+#endif
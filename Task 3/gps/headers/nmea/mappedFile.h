@@ -0,0 +1,35 @@
+#ifndef MAPPEDFILE_H_261016
+#define MAPPEDFILE_H_261016
+
+#include <string>
+#include <string_view>
+
+namespace NMEA
+{
+  /* A read-only view of the entire contents of a file.
+   * On POSIX systems a regular file is memory-mapped, so it is paged in on demand rather
+   * than copied; other files (such as FIFOs, devices and procfs files), and all files
+   * elsewhere, are read into memory.
+   */
+  class MappedFile
+  {
+    public:
+      // Throws a std::invalid_argument exception if the file cannot be opened, or is a directory.
+      explicit MappedFile(const std::string & filePath);
+      ~MappedFile();
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile & operator=(const MappedFile &) = delete;
+
+      // The file contents; only valid for the lifetime of the MappedFile.
+      std::string_view contents() const;
+
+    private:
+      const char * data = nullptr;
+      std::size_t size = 0;
+      bool isMapped = false;
+      std::string buffer; // Used when the file cannot be memory-mapped.
+  };
+}
+
+#endif
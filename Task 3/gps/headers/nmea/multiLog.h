@@ -0,0 +1,73 @@
+#ifndef MULTILOG_H_261016
+#define MULTILOG_H_261016
+
+#include <string>
+#include <vector>
+
+#include "positionBatch.h"
+#include "talkers.h"
+#include "ingestStats.h"
+
+namespace NMEA
+{
+  // The Positions decoded from one log file, with time stamp and fix quality columns.
+  struct LogPositions
+  {
+      std::string filePath;
+      GPS::PositionBatch positions{true, true};
+  };
+
+
+  /* The paths of the regular files in a directory with the given extension (or all
+   * regular files, if the extension is empty), in lexicographic order.
+   * Throws a std::invalid_argument exception if the directory cannot be read.
+   */
+  std::vector<std::string> logFilesIn(const std::string & directory, const std::string & extension = ".log");
+
+
+  /* Decodes many log files concurrently, as positionsFromLogInto() would decode each
+   * one, and returns the results in the same order as the file paths.
+   *
+   * Each thread in the pool repeatedly claims the largest file not yet claimed, so that
+   * a large file is started early rather than holding up the end of the run, and small
+   * files fill in around it.  Compressed files are decompressed as they are decoded.
+   *
+   * The 'numThreads' parameter specifies the size of the thread pool; zero means one
+   * thread per hardware thread.  The counts in the IngestStats are totals over all the
+   * files, and the elapsed time is the wall-clock time.
+   *
+   * Throws a std::invalid_argument exception if any file cannot be opened.
+   */
+  std::vector<LogPositions> positionsFromLogs(const std::vector<std::string> & filePaths,
+                                              unsigned int numThreads = 0);
+
+  std::vector<LogPositions> positionsFromLogs(const std::vector<std::string> & filePaths, const TalkerSet &,
+                                              TalkerCounts * = nullptr, unsigned int numThreads = 0,
+                                              IngestStats * = nullptr);
+
+
+  /* Merges per-file results into a single batch ordered by time stamp (a k-way merge),
+   * with time stamp and fix quality columns.
+   *
+   * Time stamps are UTC times of day, so every log is assumed to start on the same day;
+   * a time that goes back by more than 12 hours within a log is taken to be on the next
+   * day.  A Position with no valid time stamp keeps its place after the preceding
+   * Position from the same file.  Positions with equal time stamps are ordered by file,
+   * then by their order within the file.
+   *
+   * Pre-condition: the Positions within each file are in time order.
+   * Throws a std::domain_error exception if any batch has no time stamp column.
+   */
+  GPS::PositionBatch mergeByTime(const std::vector<LogPositions> &);
+
+
+  // Decodes many log files concurrently, as positionsFromLogs(), then merges them by time.
+  GPS::PositionBatch mergedPositionsFromLogs(const std::vector<std::string> & filePaths,
+                                             unsigned int numThreads = 0);
+
+  GPS::PositionBatch mergedPositionsFromLogs(const std::vector<std::string> & filePaths, const TalkerSet &,
+                                             TalkerCounts * = nullptr, unsigned int numThreads = 0,
+                                             IngestStats * = nullptr);
+}
+
+#endif
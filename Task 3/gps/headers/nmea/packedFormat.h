@@ -0,0 +1,25 @@
+#ifndef PACKEDFORMAT_H_261016
+#define PACKEDFORMAT_H_261016
+
+#include <cstdint>
+#include <string_view>
+
+namespace NMEA
+{
+  /* Packs a three-character sentence format code (e.g. "GGA") into an integer, for
+   * cheap comparisons and hashing.  Any other length of code packs to zero, which no
+   * three-character code does.
+   *
+   * This is shared by the format dispatch in parseNMEA.cpp and by IngestStats, which
+   * counts accepted sentences by packed format.
+   */
+  constexpr std::uint32_t packFormat(std::string_view format)
+  {
+      if (format.size() != 3) return 0;
+      return (std::uint32_t(std::uint8_t(format[0])) << 16)
+           | (std::uint32_t(std::uint8_t(format[1])) << 8)
+           |  std::uint32_t(std::uint8_t(format[2]));
+  }
+}
+
+#endif
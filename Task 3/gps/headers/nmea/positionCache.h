@@ -0,0 +1,114 @@
+#ifndef POSITIONCACHE_H_261016
+#define POSITIONCACHE_H_261016
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "position.h"
+#include "positionBatch.h"
+#include "mappedFile.h"
+
+namespace NMEA
+{
+  /* A compact binary cache of the Positions decoded from a log, so that the log need
+   * not be parsed again.
+   *
+   * A cache file consists of a 64-byte header, followed by four contiguous columns of
+   * 'double's: latitudes, longitudes, elevations and time stamps (NaN where unknown).
+   * The header records a format version, the byte order of the machine that wrote the
+   * file, the number of Positions, and the size and modification time of the source log.
+   * Files are only readable on machines with the same byte order.
+   */
+
+  // Identifies a particular version of a source file.
+  struct SourceKey
+  {
+      std::uint64_t size = 0;
+      std::int64_t modified = 0; // in file clock ticks
+
+      bool operator==(const SourceKey &) const;
+      bool operator!=(const SourceKey &) const;
+  };
+
+  // Throws a std::invalid_argument exception if the file does not exist.
+  SourceKey sourceKeyOf(const std::string & filePath);
+
+
+  /* A temporary path alongside 'path', for writing a file that then replaces it by
+   * renaming.  Each call gives a different path, so concurrent writers (in this or
+   * other processes) never write to the same temporary file.
+   */
+  std::string temporaryPathFor(const std::string & path);
+
+
+  /* Writes a cache file.  The file is written under a unique temporary name and then
+   * renamed, so a reader never sees a partly written cache.
+   * Throws a std::invalid_argument exception if the file cannot be written.
+   */
+  void writePositionCache(const std::string & cachePath, const GPS::PositionBatch &,
+                          const SourceKey & = {});
+
+  void writePositionCache(const std::string & cachePath, const std::vector<GPS::Position> &,
+                          const SourceKey & = {});
+
+
+  /* A read-only view of a cache file.  The file is memory-mapped, and the columns are
+   * accessed in place, without any parsing.
+   */
+  class PositionCache
+  {
+    public:
+      /* Throws a std::invalid_argument exception if the file cannot be opened, or a
+       * std::domain_error exception if it is not a valid cache file of the current version.
+       */
+      explicit PositionCache(const std::string & cachePath);
+
+      std::size_t size() const;
+
+      // The source file that the cache was made from.
+      SourceKey sourceKey() const;
+
+      // The columns, each of size() elements; only valid for the lifetime of the cache.
+      const GPS::degrees * latitudes() const;
+      const GPS::degrees * longitudes() const;
+      const GPS::metres * elevations() const;
+      const double * timeStamps() const;
+
+      // Pre-condition: the index is less than size().
+      GPS::Position operator[](std::size_t) const;
+
+      std::vector<GPS::Position> positions() const;
+
+      // Appends all the Positions (and their time stamps) to a PositionBatch.
+      void appendTo(GPS::PositionBatch &) const;
+
+    private:
+      MappedFile file;
+
+      std::size_t count;
+      SourceKey key;
+      const double * columns[4];
+  };
+
+
+  // The cache file used for a log by cachedPositionsFromLog().
+  std::string cachePathFor(const std::string & filePath);
+
+
+  /* As positionsFromLog(filePath), but reads the Positions from the cache file at
+   * cachePathFor(filePath) if that was made from the log at its current size and
+   * modification time.  Otherwise the log is decoded, and the cache file (re)written;
+   * failure to write the cache file is not an error.
+   *
+   * Only the default talker ID, "GP", is accepted.
+   *
+   * Throws a std::invalid_argument exception if the log cannot be opened.
+   */
+  std::vector<GPS::Position> cachedPositionsFromLog(const std::string & filePath);
+
+  // As above, but appends the Positions to a PositionBatch.
+  void cachedPositionsFromLogInto(const std::string & filePath, GPS::PositionBatch &);
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef RESYNCSCANNER_H_261016
+#define RESYNCSCANNER_H_261016
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "position.h"
+#include "parseNMEA.h"
+
+namespace NMEA
+{
+  /* Recovers the valid sentences from a noisy buffer, such as a raw serial capture, that
+   * may contain binary garbage, truncated sentences, and several sentences on one line.
+   *
+   * Rather than splitting the buffer into lines, the scanner hunts for '$' start markers,
+   * follows each candidate to its '*' and checksum, and validates it with scanSentence().
+   * A candidate is abandoned as soon as it reaches another '$' (where the next candidate
+   * starts), a line break, or maxSentenceLength characters.  The scan never moves
+   * backwards, so each byte is examined a bounded number of times however noisy the
+   * buffer is.
+   *
+   * The buffer must outlive the scanner, and the SentenceViews it produces.
+   */
+  class ResyncScanner
+  {
+    public:
+      /* Candidates longer than this are abandoned.  NMEA limits sentences to 82
+       * characters, but some receivers exceed that a little.
+       */
+      static const std::size_t maxSentenceLength = 128;
+
+      // Sentences are accepted from any of the specified talker IDs; by default, just "GP".
+      explicit ResyncScanner(std::string_view buffer, const TalkerSet & = TalkerSet::gps());
+
+      /* Finds the next valid sentence of a supported format (see scanSentence()).
+       * Returns false if there are no more.
+       */
+      bool next(SentenceView &);
+
+      // The offset within the buffer at which scanning will resume.
+      std::size_t offset() const;
+
+      /* The outcome of each rejected candidate so far.  Each candidate counts as a line,
+       * and the bytes read are those scanned so far.  The sentences returned by next() are
+       * not counted as accepted, as they have yet to be interpreted.
+       */
+      const IngestStats & ingestStats() const;
+
+    private:
+      std::string_view buffer;
+      TalkerSet talkers;
+      std::size_t position = 0;
+      IngestStats stats;
+
+      /* Follows the candidate starting at 'position' to the end of its checksum.
+       * Returns the candidate's length, or zero if it was abandoned, in which case
+       * 'position' is advanced to where the search should resume.
+       */
+      std::size_t candidateLength();
+  };
+
+
+  /* Decodes the Positions of all the valid sentences recovered from a noisy buffer by a
+   * ResyncScanner.  For a clean log, this gives the same Positions as positionsFromBuffer().
+   */
+  std::vector<GPS::Position> positionsFromNoisyBuffer(std::string_view);
+
+  std::vector<GPS::Position> positionsFromNoisyBuffer(std::string_view, const TalkerSet &,
+                                                      IngestStats * = nullptr);
+}
+
+#endif
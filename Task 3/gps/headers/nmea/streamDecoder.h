@@ -0,0 +1,92 @@
+#ifndef STREAMDECODER_H_261016
+#define STREAMDECODER_H_261016
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "position.h"
+#include "parseNMEA.h"
+#include "epochFusion.h"
+
+namespace NMEA
+{
+  /* Decodes NMEA sentences (one sentence per line) from a sequence of arbitrary byte
+   * chunks, such as those delivered by a serial port or socket, where a chunk may end
+   * part-way through a sentence.
+   *
+   * Each Position decoded is passed to a callback as soon as its line is complete.
+   * Lines are validated and interpreted exactly as by positionsFromLog(), so feeding
+   * the whole of a log (then calling finish()) produces the same Positions.
+   *
+   * Complete lines are decoded directly from the chunks; only a line that is split
+   * across chunks is copied, so at most one (partial) sentence is buffered.
+   */
+  class StreamDecoder
+  {
+    public:
+      using PositionHandler = std::function<void(const GPS::Position &)>;
+
+      /* Lines longer than this cannot be valid sentences (NMEA limits them to 82
+       * characters), so are discarded rather than buffered.
+       */
+      static const std::size_t maxLineLength = 1024;
+
+      /* Sentences are accepted from any of the specified talker IDs; by default, just "GP".
+       */
+      explicit StreamDecoder(PositionHandler, const TalkerSet & = TalkerSet::gps());
+
+      /* As above, but merges the sentences of each epoch into a Fix (see EpochFusion),
+       * which is passed to the callback once a later epoch begins, or at finish().
+       * This is a named function rather than a constructor overload, so that a generic
+       * lambda can be passed to either without ambiguity.
+       */
+      static StreamDecoder fusingEpochs(EpochFusion::FixHandler, const TalkerSet & = TalkerSet::gps());
+
+      // Decode the next chunk of the stream.
+      void feed(const char * data, std::size_t length);
+
+      /* Decode any final line that was not terminated by a line break, and pass on the
+       * final Fix if merging epochs.
+       * Call this at the end of the stream; the decoder can then be reused.
+       */
+      void finish();
+
+      // The number of Positions decoded so far from each talker ID.
+      const TalkerCounts & talkerCounts() const;
+
+      /* Statistics of the stream so far.  The elapsed time is the time spent in feed(),
+       * including that spent in the callback.  Overlong lines count as malformed.
+       */
+      const IngestStats & ingestStats() const;
+
+    private:
+      struct FusingEpochs {};
+      StreamDecoder(FusingEpochs, EpochFusion::FixHandler, const TalkerSet &);
+
+      PositionHandler handlePosition;
+
+      // Only used when merging epochs, in place of 'handlePosition'.
+      std::optional<EpochFusion> fusion;
+
+      TalkerSet talkers;
+      TalkerCounts decodedCounts;
+      IngestStats stats;
+
+      // The start of a line that has not yet been terminated.
+      std::string partialLine;
+
+      // Set when the current line has exceeded maxLineLength, until its line break.
+      bool discardingLine = false;
+
+      SentenceView sentence;
+
+      void feedLines(const char * data, std::size_t length);
+      void decodeLine(std::string_view);
+      void countDiscardedLine();
+  };
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef TALKERS_H_261016
+#define TALKERS_H_261016
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+namespace NMEA
+{
+  /* The two-letter talker IDs that follow the '$' of a NMEA sentence, identifying the
+   * source of the sentence.  E.g. "GP" for GPS, "GL" for GLONASS, "GA" for Galileo,
+   * "BD" or "GB" for BeiDou, and "GN" for a combined multi-constellation fix.
+   *
+   * Talker IDs consist of two upper-case letters, so there are only 26*26 of them, and
+   * each is identified by its index among those.
+   */
+  const std::size_t numTalkerIDs = 26 * 26;
+
+  /* Returns the index of a talker ID, or numTalkerIDs if the characters are not both
+   * upper-case letters.
+   */
+  inline std::size_t talkerIndex(char first, char second)
+  {
+      const unsigned int firstLetter  = static_cast<unsigned char>(first)  - 'A';
+      const unsigned int secondLetter = static_cast<unsigned char>(second) - 'A';
+      return (firstLetter < 26 && secondLetter < 26) ? firstLetter * 26 + secondLetter : numTalkerIDs;
+  }
+
+
+  // A set of talker IDs, e.g. those whose sentences should be accepted.
+  class TalkerSet
+  {
+    public:
+      /* Throws a std::invalid_argument exception if any talker ID is not two upper-case
+       * letters.
+       */
+      TalkerSet(std::initializer_list<std::string_view>);
+
+      // Just "GP", the only talker ID accepted by default.
+      static const TalkerSet & gps();
+
+      // The GPS, GLONASS, Galileo, BeiDou and combined talker IDs.
+      static const TalkerSet & allConstellations();
+
+      /* Determine whether the talker ID made up of the two characters is in the set.
+       * This is a table look-up, rather than a string comparison.
+       */
+      bool contains(char first, char second) const
+      {
+          const std::size_t index = talkerIndex(first, second);
+          return index < numTalkerIDs && members[index];
+      }
+
+      bool contains(std::string_view) const;
+
+    private:
+      std::bitset<numTalkerIDs> members;
+  };
+
+
+  // Counts of sentences for each talker ID.
+  class TalkerCounts
+  {
+    public:
+      // Pre-condition: the characters are both upper-case letters.
+      void add(char first, char second)
+      {
+          ++counts[talkerIndex(first, second)];
+      }
+
+      /* The count for the specified talker ID.
+       * Throws a std::invalid_argument exception if it is not two upper-case letters.
+       */
+      std::uint64_t operator[](std::string_view) const;
+
+      // The total count over all talker IDs.
+      std::uint64_t total() const;
+
+      TalkerCounts & operator+=(const TalkerCounts &);
+
+    private:
+      std::array<std::uint64_t,numTalkerIDs> counts = {};
+  };
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef TIMEINDEX_H_261016
+#define TIMEINDEX_H_261016
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "positionBatch.h"
+#include "positionCache.h"
+#include "talkers.h"
+
+namespace NMEA
+{
+  /* A sparse index from times to byte offsets in a log, so that the sentences in a time
+   * range can be decoded without reading the rest of the log.
+   *
+   * An epoch is a run of sentences with the same time stamp.  The index records the time
+   * and the offset of the first line of every Nth epoch.
+   *
+   * Times are in seconds since midnight (UTC) at the start of the log's first day, so
+   * that they keep increasing across midnight: as elsewhere, a time that goes back by
+   * more than 12 hours is taken to be on the next day.  For a log within one day, these
+   * are simply times of day.
+   *
+   * Pre-condition: apart from crossing midnight, the times in the log never decrease.
+   */
+  struct TimeIndex
+  {
+      static const std::size_t defaultEpochsPerEntry = 64;
+
+      std::size_t epochsPerEntry = defaultEpochsPerEntry;
+
+      // The log that the index was made from.
+      SourceKey sourceKey;
+
+      // The time and byte offset of the first line of each indexed epoch.
+      std::vector<double> times;
+      std::vector<std::uint64_t> offsets;
+
+      /* The range of byte offsets [first, second) of a log of the specified size that
+       * holds every sentence timed within [from, to].
+       */
+      std::pair<std::uint64_t,std::uint64_t> byteRange(double from, double to, std::uint64_t logSize) const;
+  };
+
+
+  /* Builds the index of a log held in a buffer, in a single pass that tokenises each line
+   * with scanSentence() but decodes only the time field.  Sentences are accepted from any
+   * of the specified talker IDs.  The index's source key is left empty.
+   *
+   * Throws a std::invalid_argument exception if 'epochsPerEntry' is zero.
+   */
+  TimeIndex buildTimeIndex(std::string_view log, std::size_t epochsPerEntry = TimeIndex::defaultEpochsPerEntry,
+                           const TalkerSet & = TalkerSet::gps());
+
+
+  /* Writes an index to a small sidecar file: a 64-byte header (like that of a position
+   * cache), followed by the times and then the offsets.  The file is written under a
+   * unique temporary name and then renamed.
+   * Throws a std::invalid_argument exception if the file cannot be written.
+   */
+  void writeTimeIndex(const std::string & indexPath, const TimeIndex &);
+
+
+  /* Throws a std::invalid_argument exception if the file cannot be opened, or a
+   * std::domain_error exception if it is not a valid index file of the current version.
+   */
+  TimeIndex readTimeIndex(const std::string & indexPath);
+
+
+  // The index file used for a log by positionsBetween().
+  std::string timeIndexPathFor(const std::string & filePath);
+
+
+  /* Decodes only the Positions in a log timed within [from, to] (see TimeIndex for the
+   * time scale), with their time stamps (times of day) and fix qualities.
+   *
+   * Uses the index at timeIndexPathFor(filePath) if it was made from the log at its
+   * current size and modification time; otherwise the index is built and the file
+   * (re)written, and failure to write it is not an error.  The log is memory-mapped,
+   * and only the slice between the enclosing index entries is decoded.
+   *
+   * Compressed logs cannot be sliced, so are decoded in full, without an index.
+   * Only the default talker ID, "GP", is accepted.
+   *
+   * Throws a std::invalid_argument exception if the log cannot be opened.
+   */
+  GPS::PositionBatch positionsBetween(const std::string & filePath, double from, double to);
+}
+
+#endif
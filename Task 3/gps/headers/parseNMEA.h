@@ -2,11 +2,22 @@
 #define PARSENMEA_H_211217
 
 #include <string>
+#include <string_view>
 #include <list>
 #include <vector>
+#include <array>
+#include <cstdint>
 #include <istream>
+#include <optional>
+#include <ctime>
 
 #include "position.h"
+#include "points.h"
+#include "positionBatch.h"
+#include "nmea/decodeQuery.h"
+#include "nmea/expected.h"
+#include "nmea/ingestStats.h"
+#include "nmea/talkers.h"
 
 namespace NMEA
 {
@@ -14,7 +25,7 @@ namespace NMEA
    * that is currently supported.
    * Currently the only supported sentence formats are "GLL", "GGA" and "RMC".
    */
-  bool isSupportedSentenceFormat(std::string);
+  bool isSupportedSentenceFormat(std::string_view);
 
 
   /* Determine whether the parameter is a well-formed NMEA sentence.
@@ -33,7 +44,12 @@ namespace NMEA
    *
    * Note that this function does NOT check whether the sentence format is supported.
    */
-  bool isWellFormedSentence(std::string);
+  bool isWellFormedSentence(std::string_view);
+
+
+  /* As above, but accepting any of the specified talker IDs in place of "GP".
+   */
+  bool isWellFormedSentence(std::string_view, const TalkerSet &);
 
 
   /* Verify whether a sentence has the correct checksum.
@@ -42,7 +58,7 @@ namespace NMEA
    *
    * Pre-condition: the parameter is a well-formed NMEA sentence.
    */
-  bool hasCorrectChecksum(std::string);
+  bool hasCorrectChecksum(std::string_view);
 
 
   // Stores the fields of a NMEA sentence, excluding the checksum.
@@ -62,11 +78,137 @@ namespace NMEA
 
 
   /* Extracts the sentence format and the field contents from a NMEA sentence string.
-   * The '$GP' and the checksum are ignored.
+   * The '$', the talker ID (e.g. 'GP') and the checksum are ignored.
    *
    * Pre-condition: the parameter is a well-formed NMEA sentence.
    */
-  SentenceData parseSentenceData(std::string);
+  SentenceData parseSentenceData(std::string_view);
+
+
+  // The outcome of scanning a candidate NMEA sentence.
+  enum class SentenceStatus
+  {
+      ok,                // well-formed, correct checksum, and a supported format
+      malformed,         // not a well-formed sentence (see isWellFormedSentence())
+      badChecksum,       // well-formed, but the checksum does not match
+      unsupportedFormat  // well-formed with a correct checksum, but not a supported format
+  };
+
+
+  /* A non-owning alternative to SentenceData.
+   * Rather than copying the format and data fields into strings, a SentenceView
+   * records the offsets of the field delimiters within the caller's sentence buffer,
+   * so no heap allocation takes place.  The buffer must outlive the view.
+   *
+   * The offsets of the first 'inlineFields' fields are stored within the view itself;
+   * only sentences with more fields than that spill the remaining offsets to the heap.
+   * A view that is reused for many sentences keeps its spill capacity.
+   */
+  class SentenceView
+  {
+    public:
+      /* The maximum number of data fields that a SentenceView can hold.
+       * Standard NMEA sentences are at most 82 characters long, so never get near this.
+       */
+      static const std::size_t maxFields = 80;
+
+      /* The number of data fields stored without a heap allocation.
+       * This covers all the standard GPS sentences (GSV has the most, at 19).
+       */
+      static const std::size_t inlineFields = 24;
+
+      SentenceView() = default;
+
+      // The talker ID that follows the '$'.  E.g. "GP".
+      std::string_view talker() const;
+
+      // The NMEA sentence format, excluding the talker ID.  E.g. "GLL".
+      std::string_view format() const;
+
+      // The number of data fields, excluding the format and checksum.
+      std::size_t numFields() const;
+
+      /* The contents of the specified data field (numbered from zero).
+       * Throws a std::out_of_range exception if the index is out-of-range.
+       */
+      std::string_view field(std::size_t) const;
+
+      // A synonym for field(), for symmetry with field<T>().
+      std::string_view fieldView(std::size_t) const;
+
+      /* The value of the specified data field, decoded on demand.
+       * Supported types are double (decoded as by GPS::parseDecimal()) and
+       * std::string_view.
+       *
+       * Throws a std::out_of_range exception if the index is out-of-range, or a
+       * std::invalid_argument exception if the field cannot be decoded as a T.
+       */
+      template <typename T>
+      T field(std::size_t) const;
+
+      /* As field<double>(), but returns false rather than throwing an exception if the
+       * index is out-of-range or the field is not a plain decimal.  The result is stored
+       * in the second parameter.
+       */
+      bool tryField(std::size_t, double &) const;
+
+    private:
+      std::string_view sentence;
+      std::size_t fieldCount = 0;
+
+      /* Offsets into 'sentence' of each ',' that starts a data field, followed by
+       * the offset of the terminating '*'.  Those beyond the inline array are stored
+       * in 'spilledDelimiters'.
+       */
+      std::array<std::uint16_t,inlineFields+1> inlineDelimiters = {};
+      std::vector<std::uint16_t> spilledDelimiters;
+
+      std::uint16_t delimiter(std::size_t) const;
+
+      // Resets the view to have no fields, with the first ',' at the specified offset.
+      void startFields(std::uint16_t firstDelimiter);
+
+      // Ends the current data field at the specified offset.
+      void endField(std::uint16_t delimiter);
+
+      friend SentenceView parseSentenceView(std::string_view);
+      friend SentenceStatus scanSentence(std::string_view, SentenceView &, const TalkerSet &);
+  };
+
+  template <>
+  double SentenceView::field<double>(std::size_t) const;
+
+  template <>
+  std::string_view SentenceView::field<std::string_view>(std::size_t) const;
+
+
+  /* Extracts the sentence format and the field offsets from a NMEA sentence string,
+   * without copying any of its contents.
+   * The '$', the talker ID (e.g. 'GP') and the checksum are ignored.
+   *
+   * Throws a std::length_error exception if the sentence has more than
+   * SentenceView::maxFields data fields.
+   *
+   * Pre-condition: the parameter is a well-formed NMEA sentence.
+   */
+  SentenceView parseSentenceView(std::string_view);
+
+
+  /* Validates and tokenises a candidate NMEA sentence.
+   * This combines isWellFormedSentence(), hasCorrectChecksum(), isSupportedSentenceFormat()
+   * and parseSentenceView(), but reads each character only once: the header and checksum
+   * one character at a time, and each data field with a ByteScan kernel that finds the next
+   * delimiter while accumulating the checksum.
+   *
+   * The SentenceView parameter is only meaningful if the result is SentenceStatus::ok.
+   * Sentences with more than SentenceView::maxFields data fields are reported as malformed.
+   */
+  SentenceStatus scanSentence(std::string_view, SentenceView &);
+
+
+  /* As above, but accepting any of the specified talker IDs in place of "GP".
+   */
+  SentenceStatus scanSentence(std::string_view, SentenceView &, const TalkerSet &);
 
 
   /* Computes a Position from NMEA Sentence Data.
@@ -78,17 +220,219 @@ namespace NMEA
   GPS::Position interpretSentenceData(SentenceData);
 
 
+  /* As above, but reads the data fields directly from the sentence buffer.
+   */
+  GPS::Position interpretSentenceData(const SentenceView &);
+
+
+  // The reasons that interpreting sentence data can fail.
+  enum class InterpretError
+  {
+      unsupportedFormat,
+      missingFields,
+      invalidFields,
+      filteredOut // valid, but excluded by a DecodeQuery
+  };
+
+  using InterpretResult = Expected<GPS::Position,InterpretError>;
+
+
+  /* As interpretSentenceData(), but reports failures as an InterpretError rather than
+   * by throwing an exception, so that rejecting a sentence is as cheap as accepting one.
+   */
+  InterpretResult tryInterpretSentenceData(const SentenceData &);
+  InterpretResult tryInterpretSentenceData(const SentenceView &);
+
+
+  /* As above, but only decodes the outputs that the query asks for, and reports
+   * sentences excluded by the query as InterpretError::filteredOut.  The query's
+   * predicates are checked as early as possible (see DecodeQuery), so an excluded
+   * sentence costs less to decode than an accepted one.
+   */
+  InterpretResult tryInterpretSentenceData(const SentenceView &, const DecodeQuery &);
+
+
+  /* Returns the UTC time of day of a supported sentence, in seconds since midnight.
+   * Returns GPS::PositionBatch::unknownTimeStamp (NaN) if the time field is missing or
+   * is not of the form "hhmmss" or "hhmmss.ss".
+   */
+  double timeOfDay(const SentenceView &);
+
+
+  /* Returns the quality of the fix reported by a supported sentence.
+   * For GGA sentences this is the fix quality field (0 for no fix, 1 for a GPS fix,
+   * 2 for a differential GPS fix, etc.).  For GLL and RMC sentences, the status 'A'
+   * (valid) is reported as 1, and 'V' (void) as 0.
+   * Returns GPS::PositionBatch::unknownFixQuality if the field is missing or invalid.
+   */
+  std::uint8_t fixQuality(const SentenceView &);
+
+
+  /* Returns the UTC date of a supported sentence, with the time fields zeroed.
+   * Only RMC sentences contain dates (as "ddmmyy"); for other formats, or if the date
+   * field is missing or invalid, returns an empty std::optional.
+   */
+  std::optional<std::tm> dateOf(const SentenceView &);
+
+
+  /* Return the speed over ground (converted to metres per second) and the course over
+   * ground (in degrees from true north) of a supported sentence.
+   * Only RMC sentences contain these; for other formats, or if the field is missing or
+   * invalid, returns an empty std::optional.
+   */
+  std::optional<GPS::speed> groundSpeedOf(const SentenceView &);
+  std::optional<GPS::degrees> courseOf(const SentenceView &);
+
+
+  /* Validates, tokenises and interprets a single line of a log, as positionsFromLog()
+   * does, and records the outcome (but not the bytes read) in an IngestStats.
+   * One trailing '\r' is ignored, so lines may end with either "\n" or "\r\n".
+   * Returns the Position if the line is accepted, or an empty std::optional otherwise.
+   * The SentenceView parameter is only meaningful if a Position is returned.
+   */
+  std::optional<GPS::Position> decodeLogLine(std::string_view line, SentenceView &,
+                                             const TalkerSet &, IngestStats &);
+
+  // As above, but sentences excluded by the query are counted as filtered.
+  std::optional<GPS::Position> decodeLogLine(std::string_view line, SentenceView &,
+                                             const TalkerSet &, IngestStats &, const DecodeQuery &);
+
+
   /* Reads a stream of NMEA sentences (one sentence per line), and constructs a
    * vector of Positions, ignoring any lines that do not contain valid sentences.
+   * Lines may end with either "\n" or "\r\n".
    *
    * A line is a valid sentence if all of the following are true:
    *  - the line is a well-formed NMEA sentence;
    *  - the checksum is valid;
    *  - the sentence format is supported (currently GLL, GGA and RMC);
    *  - the neccessary data fields are present and contain valid data.
+   *
+   * Each line is read into a single reused buffer and validated and tokenised by a
+   * single scanSentence() pass, so no heap allocation takes place per line (other
+   * than to grow the result).
    */
   std::vector<GPS::Position> positionsFromLog(std::istream &);
 
+
+  /* As above, but accepting sentences from any of the specified talker IDs in place of
+   * just "GP".  If a TalkerCounts is supplied, the sentences that produce Positions are
+   * added to it, according to their talker IDs.  If an IngestStats is supplied, the
+   * statistics of this log are added to it.
+   */
+  std::vector<GPS::Position> positionsFromLog(std::istream &, const TalkerSet &,
+                                              TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+
+  /* As above, but decodes the sentences held in a buffer, with lines separated by '\n'
+   * (or "\r\n").
+   */
+  std::vector<GPS::Position> positionsFromBuffer(std::string_view);
+
+  std::vector<GPS::Position> positionsFromBuffer(std::string_view, const TalkerSet &,
+                                                 TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+
+  /* As above, but reads the log from the named file.
+   * The file is memory-mapped, split into chunks at line boundaries, and the chunks are
+   * decoded concurrently on a pool of threads.  The Positions are returned in the same
+   * order as positionsFromLog(std::istream &) would return them.
+   *
+   * The 'numThreads' parameter specifies the size of the thread pool; zero means one
+   * thread per hardware thread.
+   *
+   * The elapsed time in the IngestStats is the wall-clock time, not the total over
+   * the threads.
+   *
+   * gzip or zstd compressed files (see GPS::InputFile) are instead decompressed on a
+   * background thread while being decoded on the calling thread.
+   *
+   * Throws a std::invalid_argument exception if the file cannot be opened, or a
+   * std::domain_error exception if it is compressed but cannot be decompressed.
+   */
+  std::vector<GPS::Position> positionsFromLog(const std::string & filePath, unsigned int numThreads = 0);
+
+  std::vector<GPS::Position> positionsFromLog(const std::string & filePath, const TalkerSet &,
+                                              TalkerCounts * = nullptr, unsigned int numThreads = 0,
+                                              IngestStats * = nullptr);
+
+
+  /* As positionsFromLog(), but appends the Positions to a PositionBatch in place, so
+   * that one batch can be grown across several logs.  If the batch has time stamp or
+   * fix quality columns, they are filled using timeOfDay() and fixQuality().
+   */
+  void positionsFromLogInto(std::istream &, GPS::PositionBatch &);
+
+  void positionsFromLogInto(std::istream &, GPS::PositionBatch &, const TalkerSet &,
+                            TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+  void positionsFromLogInto(const std::string & filePath, GPS::PositionBatch &);
+
+  void positionsFromLogInto(const std::string & filePath, GPS::PositionBatch &, const TalkerSet &,
+                            TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+  void positionsFromBufferInto(std::string_view, GPS::PositionBatch &);
+
+  void positionsFromBufferInto(std::string_view, GPS::PositionBatch &, const TalkerSet &,
+                               TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+
+  /* As the functions above, but only decoding what the query asks for and only returning
+   * the Positions that satisfy it.  The excluded sentences are counted as filtered in the
+   * IngestStats, and are not added to the TalkerCounts.
+   */
+  std::vector<GPS::Position> positionsFromLog(std::istream &, const DecodeQuery &,
+                                              const TalkerSet & = TalkerSet::gps(),
+                                              TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+  std::vector<GPS::Position> positionsFromBuffer(std::string_view, const DecodeQuery &,
+                                                 const TalkerSet & = TalkerSet::gps(),
+                                                 TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+  std::vector<GPS::Position> positionsFromLog(const std::string & filePath, const DecodeQuery &,
+                                              const TalkerSet & = TalkerSet::gps(),
+                                              TalkerCounts * = nullptr, unsigned int numThreads = 0,
+                                              IngestStats * = nullptr);
+
+  void positionsFromLogInto(std::istream &, GPS::PositionBatch &, const DecodeQuery &,
+                            const TalkerSet & = TalkerSet::gps(),
+                            TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+  void positionsFromLogInto(const std::string & filePath, GPS::PositionBatch &, const DecodeQuery &,
+                            const TalkerSet & = TalkerSet::gps(),
+                            TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+  void positionsFromBufferInto(std::string_view, GPS::PositionBatch &, const DecodeQuery &,
+                               const TalkerSet & = TalkerSet::gps(),
+                               TalkerCounts * = nullptr, IngestStats * = nullptr);
+
+
+  /* Reads a stream of NMEA sentences in a single pass, and constructs a vector of
+   * TrackPoints suitable for constructing a GPS::Track.  Lines are accepted as for
+   * positionsFromLog(), except that sentences without a valid UTC time are also skipped.
+   *
+   * Each TrackPoint is dated with the UTC date of the most recent RMC sentence (or of
+   * the first RMC sentence, for those that precede it), and timed using its own time
+   * field, allowing for sentences either side of midnight.  TrackPoint names are empty.
+   *
+   * Throws a std::domain_error exception if there are time-stamped sentences but no RMC
+   * sentence with a valid date.
+   */
+  std::vector<GPS::TrackPoint> trackPointsFromLog(std::istream &);
+
+  std::vector<GPS::TrackPoint> trackPointsFromLog(std::istream &, const TalkerSet &,
+                                                  TalkerCounts * = nullptr);
+
+  std::vector<GPS::TrackPoint> trackPointsFromLog(const std::string & filePath);
+
+  std::vector<GPS::TrackPoint> trackPointsFromLog(const std::string & filePath, const TalkerSet &,
+                                                  TalkerCounts * = nullptr);
+
+  std::vector<GPS::TrackPoint> trackPointsFromBuffer(std::string_view);
+
+  std::vector<GPS::TrackPoint> trackPointsFromBuffer(std::string_view, const TalkerSet &,
+                                                     TalkerCounts * = nullptr);
+
 }
 
 #endif
@@ -1,9 +1,13 @@
 #ifndef POSITION_H_211217
 #define POSITION_H_211217
 
+#include <optional>
 #include <string>
+#include <stdexcept>
+#include <string_view>
 
 #include "types.h"
+#include "geometry.h"
 
 namespace GPS
 {
@@ -13,8 +17,10 @@ namespace GPS
 
       /* Construct a Position from degrees latitude, degrees longitude, and
        * (optionally) elevation in metres.
+       * This is constexpr, so constant Positions (e.g. those in earth.h) are built at
+       * compile time.
        */
-      Position(degrees lat, degrees lon, metres ele = 0.0);
+      constexpr Position(degrees lat, degrees lon, metres ele = 0.0);
 
 
       /* Construct a Position from strings containing a decimal degrees
@@ -35,9 +41,28 @@ namespace GPS
                std::string ddmLonStr, char easting,
                std::string eleSt = "0");
 
-      degrees latitude() const;
-      degrees longitude() const;
-      metres  elevation() const;
+      /* As above, but parses the DDM and elevation strings directly, without allocating
+       * or consulting the locale (see parseDecimal() below).  Gives exactly the same
+       * Position as the constructor for the same (plain decimal) strings.
+       *
+       * Throws a std::invalid_argument exception if any string is not a plain decimal
+       * number, or for the same reasons as the constructor.
+       */
+      static Position fromDDM(std::string_view ddmLatStr, char northing,
+                              std::string_view ddmLonStr, char easting,
+                              std::string_view eleStr = "0");
+
+
+      /* As above, but returns an empty std::optional rather than throwing an exception
+       * if any of the parameters are invalid.
+       */
+      static std::optional<Position> tryFromDDM(std::string_view ddmLatStr, char northing,
+                                                std::string_view ddmLonStr, char easting,
+                                                std::string_view eleStr = "0");
+
+      constexpr degrees latitude() const;
+      constexpr degrees longitude() const;
+      constexpr metres  elevation() const;
 
       /* Computes an approximation of the horizontal distance between two Positions
        * on the Earth's surface. Does not take into account elevation.
@@ -51,10 +76,94 @@ namespace GPS
   };
 
 
+  constexpr Position::Position(degrees lat, degrees lon, metres ele)
+      : lat(lat), lon(lon), ele(ele)
+  {
+      if (lat > poleLatitude || lat < -poleLatitude)
+          throw std::invalid_argument("Latitude values must not exceed " + std::to_string(poleLatitude) + " degrees.");
+
+      if (lon > antiMeridianLongitude || lon < -antiMeridianLongitude)
+          throw std::invalid_argument("Longitude values must not exceed " + std::to_string(antiMeridianLongitude) + " degrees.");
+  }
+
+  constexpr degrees Position::latitude() const
+  {
+      return lat;
+  }
+
+  constexpr degrees Position::longitude() const
+  {
+      return lon;
+  }
+
+  constexpr metres Position::elevation() const
+  {
+      return ele;
+  }
+
+
+  /* A Position along with the parts of a distance calculation that depend only on that
+   * Position: its latitude and longitude in radians, and the cosine of its latitude.
+   * Preparing a Position that takes part in many distance calculations (e.g. the fixed
+   * point of a one-to-many query) avoids recomputing them for every distance.
+   *
+   * Distances are exactly the same as Position::horizontalDistanceBetween() gives.
+   */
+  class PreparedPosition
+  {
+    public:
+      explicit PreparedPosition(Position);
+
+      const Position & position() const;
+      radians latitudeRadians() const;
+      radians longitudeRadians() const;
+      double  cosLatitude() const;
+
+      // As Position::horizontalDistanceBetween().
+      static metres horizontalDistanceBetween(const PreparedPosition &, const PreparedPosition &);
+
+      // As above, but only preparing the second Position.
+      static metres horizontalDistanceBetween(const PreparedPosition &, Position);
+
+    private:
+      Position pos;
+      radians  lat;
+      radians  lon;
+      double   cosLat;
+  };
+
+
   /* Convert a DDM (degrees and decimal minutes) string representation of an angle to a
      DD (decimal degrees) value.
    */
   degrees ddmTodd(std::string);
+
+
+  /* Parse a plain decimal number, e.g. "-12", "5425.31" or ".5", with no exponent,
+   * surrounding whitespace or other characters.
+   * Unlike std::stod(), this does not allocate or consult the locale, and most values
+   * are converted with a single floating-point division.  The result is exactly the
+   * same as std::stod() would give.
+   *
+   * Throws a std::invalid_argument exception if the parameter is not a plain decimal.
+   */
+  double parseDecimal(std::string_view);
+
+
+  /* As above, but returns false rather than throwing an exception if the parameter is
+   * not a plain decimal.  The result is stored in the second parameter.
+   */
+  bool tryParseDecimal(std::string_view, double &);
+
+
+  // As ddmTodd(), but parses the string with parseDecimal().
+  degrees parseDDM(std::string_view);
+
+
+  /* As above, but returns false rather than throwing an exception if the parameter is
+   * not a plain decimal.  The result is stored in the second parameter.
+   */
+  bool tryParseDDM(std::string_view, degrees &);
 }
 
 #endif
@@ -0,0 +1,84 @@
+#ifndef POSITIONBATCH_H_261016
+#define POSITIONBATCH_H_261016
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "types.h"
+#include "position.h"
+
+namespace GPS
+{
+  /* A sequence of Positions stored as separate contiguous columns of latitudes,
+   * longitudes and elevations (a "structure of arrays"), rather than as a vector of
+   * Position objects.  This suits kernels that process one coordinate of many
+   * positions at a time.
+   *
+   * A batch may also carry a column of time stamps (in seconds) and a column of fix
+   * qualities.  Whether these columns are present is fixed when the batch is
+   * constructed.
+   */
+  class PositionBatch
+  {
+    public:
+      // Values for positions where no time stamp or fix quality is known.
+      static constexpr double unknownTimeStamp = std::numeric_limits<double>::quiet_NaN();
+      static constexpr std::uint8_t unknownFixQuality = 255;
+
+      explicit PositionBatch(bool hasTimeStamps = false, bool hasFixQualities = false);
+
+      std::size_t size() const;
+      bool empty() const;
+
+      // Reserves capacity in every column.
+      void reserve(std::size_t);
+
+      void clear();
+
+      /* Appends a Position.  The time stamp and fix quality are ignored if the batch
+       * has no such columns.
+       */
+      void push_back(const Position &,
+                     double timeStamp = unknownTimeStamp,
+                     std::uint8_t fixQuality = unknownFixQuality);
+
+      /* Appends 'count' Positions given as columns of valid coordinates.  The time stamps
+       * may be nullptr, in which case they are unknown; the fix qualities are unknown.
+       */
+      void append(std::size_t count, const degrees * lats, const degrees * lons, const metres * eles,
+                  const double * timeStamps = nullptr);
+
+      // Pre-condition: the index is less than size().
+      Position operator[](std::size_t index) const;
+
+      const std::vector<degrees> & latitudes() const;
+      const std::vector<degrees> & longitudes() const;
+      const std::vector<metres> & elevations() const;
+
+      bool hasTimeStamps() const;
+      bool hasFixQualities() const;
+
+      // Throws a std::domain_error exception if the batch has no time stamp column.
+      const std::vector<double> & timeStamps() const;
+
+      // Throws a std::domain_error exception if the batch has no fix quality column.
+      const std::vector<std::uint8_t> & fixQualities() const;
+
+    private:
+      bool withTimeStamps;
+      bool withFixQualities;
+
+      std::vector<degrees> lats;
+      std::vector<degrees> lons;
+      std::vector<metres> eles;
+      std::vector<double> times;
+      std::vector<std::uint8_t> qualities;
+      /* Class Invariant:
+       *   'lats', 'lons' and 'eles' have the same length; 'times' and 'qualities' also have
+       *   that length if the corresponding columns are present, and are empty otherwise.
+       */
+  };
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "types.h"
 #include "position.h"
 #include "points.h"
+#include "distanceModel.h"
 
 namespace GPS
 {
@@ -16,12 +17,35 @@ namespace GPS
     protected:
       std::list<RoutePoint> routePoints;
 
+      /* A PreparedPosition for each route point, used by the one-to-many distance queries
+       * so that the route points' radians and cos(latitude) are only computed once.
+       */
+      std::vector<PreparedPosition> preparedPositions;
+
+      /* The latitudes and longitudes of the route points as separate columns, for the batch
+       * distance implementations.
+       */
+      std::vector<degrees> latitudes;
+      std::vector<degrees> longitudes;
+
+      // The model used for all horizontal distances.
+      const DistanceModel * model = &DistanceModels::haversine();
+
       /* Class Invariant:
        *   - There is always at least one RoutePoint in the 'routePoints' list - it is never empty.
+       *   - 'preparedPositions' holds the Positions of 'routePoints', in the same order.
+       *   - 'latitudes' and 'longitudes' hold the coordinates of 'routePoints', in the same order.
        */
 
     public:
-      Route(std::vector<RoutePoint>);
+      /* Horizontal distances are computed using the specified DistanceModel.
+       * Throws a std::invalid_argument exception if the vector of RoutePoints is empty.
+       */
+      Route(std::vector<RoutePoint>, const DistanceModel & = DistanceModels::haversine());
+
+
+      // The model used for horizontal distances.
+      const DistanceModel & distanceModel() const;
 
 
       // Returns the number of stored route points.
@@ -140,6 +164,21 @@ namespace GPS
 
     protected:
       Route() = default; // For use by Track subclass
+
+
+      /* Rebuild 'preparedPositions', 'latitudes' and 'longitudes' from 'routePoints'.
+       * Subclasses must call this whenever they change 'routePoints'.
+       */
+      void preparePositions();
+
+
+      /* The horizontal distances between successive route points (one fewer than the number
+       * of points), computed together as a batch if the DistanceModel has a batch implementation.
+       * A SIMD batch implementation can differ very slightly from the model's single distance
+       * used by the point queries (see batchDistance.h for the bound), so a leg length need not
+       * exactly equal the distance between its end points given by those queries.
+       */
+      std::vector<metres> horizontalLegLengths() const;
   };
 }
 
@@ -43,8 +43,10 @@ namespace GPS
     public:
       /*  The 'granularity' parameter is the minimum distance between successive route points.
        *  Any route points closer to their predecessor than this are discarded.
+       *  Horizontal distances are computed using the specified DistanceModel.
        */
-      Track(std::vector<TrackPoint>, metres granularity = 10);
+      Track(std::vector<TrackPoint>, metres granularity = 10,
+            const DistanceModel & = DistanceModels::haversine());
 
 
       /* Update the granularity of the stored track.  Any position in the track that differs in
@@ -121,6 +123,9 @@ namespace GPS
        */
       bool areSameLocation(Position,Position) const;
 
+      // As above, for Positions that have already been prepared.
+      bool areSameLocation(const PreparedPosition&,const PreparedPosition&) const;
+
       static TimeStamp tmToTimeStamp(std::tm);
   };
 }
@@ -0,0 +1,320 @@
+#include <cmath>
+#include <iterator>
+
+#include "geometry.h"
+#include "earth.h"
+#include "batchDistance.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define GPS_BATCHDISTANCE_X86
+  #include <immintrin.h>
+#endif
+
+namespace GPS
+{
+  namespace BatchDistance
+  {
+      namespace
+      {
+          // The same calculation as Position::horizontalDistanceBetween(), without constructing Positions.
+          void scalarPairwise(const degrees * lat1s, const degrees * lon1s,
+                              const degrees * lat2s, const degrees * lon2s,
+                              metres * out, std::size_t n)
+          {
+              for (std::size_t i = 0; i < n; ++i)
+              {
+                  const radians lat1 = degToRad(lat1s[i]);
+                  const radians lat2 = degToRad(lat2s[i]);
+                  const radians lon1 = degToRad(lon1s[i]);
+                  const radians lon2 = degToRad(lon2s[i]);
+
+                  double h = sinSqr((lat2-lat1)/2) + Trig::cos<trigPrecision>(lat1)*Trig::cos<trigPrecision>(lat2)*sinSqr((lon2-lon1)/2);
+                  out[i] = 2 * Earth::meanRadius * Trig::asin<trigPrecision>(std::sqrt(h));
+              }
+          }
+
+#ifdef GPS_BATCHDISTANCE_X86
+          /* The SIMD kernels reduce angles to r in [-pi/4,pi/4], where x = r + n*pi/2,
+           * and then evaluate truncated Taylor series for sin(r) and cos(r).  The
+           * truncation error is below 1e-17 on that interval, so the result is limited
+           * by rounding error (a few ulp).  Only |sin x| and |cos x| are needed, so the
+           * quadrant only decides whether sin(r) or cos(r) is used, not the sign.
+           *
+           * asin(s) is reduced to a Taylor series on [0,0.26] by two identities:
+           *   asin(s) = pi/2 - 2 asin(sqrt((1-s)/2))      for s > 1/2
+           *   asin(t) = 2 asin(t / sqrt(2 + 2 sqrt(1-t^2)))
+           *
+           * Degrees are converted to radians in the same way as degToRad(), so that the
+           * trig functions see the same arguments as in the scalar kernel.
+           *
+           * Any tail of fewer than a whole vector of pairs is handed over to the scalar kernel.
+           */
+
+          // The number of terms of the Trig series for sin(x)/x, cos(x) and asin(x)/x respectively.
+          constexpr std::size_t sinTermCount = 10;
+          constexpr std::size_t cosTermCount = 10;
+          constexpr std::size_t asinTermCount = 14;
+
+          static_assert(sinTermCount <= std::size(Trig::sinTerms) && cosTermCount <= std::size(Trig::cosTerms) &&
+                        asinTermCount <= std::size(Trig::asinTerms), "Not enough terms in the Trig series.");
+
+          // pi/2 split into its nearest double and the remainder, for an accurate reduction.
+          const double halfPiHigh = 1.5707963267948966;
+          const double halfPiLow = 6.123233995736766e-17;
+
+          __attribute__((target("avx2,fma")))
+          __m256d avx2Set(double x)
+          {
+              return _mm256_set1_pd(x);
+          }
+
+          template <std::size_t N>
+          __attribute__((target("avx2,fma")))
+          __m256d avx2Polynomial(__m256d x, const double * coefficients)
+          {
+              __m256d result = avx2Set(coefficients[N-1]);
+              for (std::size_t i = N-1; i-- > 0; )
+              {
+                  result = _mm256_fmadd_pd(result, x, avx2Set(coefficients[i]));
+              }
+              return result;
+          }
+
+          // Reduces x to r, returning a mask of the lanes where n is odd.
+          __attribute__((target("avx2,fma")))
+          __m256d avx2Reduce(__m256d x, __m256d & r)
+          {
+              const __m256d n = _mm256_round_pd(_mm256_mul_pd(x, avx2Set(1/halfPiHigh)),
+                                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+              r = _mm256_fnmadd_pd(n, avx2Set(halfPiHigh), x);
+              r = _mm256_fnmadd_pd(n, avx2Set(halfPiLow), r);
+              const __m256d half = _mm256_mul_pd(n, avx2Set(0.5));
+              return _mm256_cmp_pd(_mm256_floor_pd(half), half, _CMP_NEQ_OQ);
+          }
+
+          __attribute__((target("avx2,fma")))
+          __m256d avx2SinSqr(__m256d x)
+          {
+              __m256d r;
+              const __m256d odd = avx2Reduce(x, r);
+              const __m256d r2 = _mm256_mul_pd(r, r);
+              const __m256d sinR = _mm256_mul_pd(r, avx2Polynomial<sinTermCount>(r2, Trig::sinTerms));
+              const __m256d cosR = avx2Polynomial<cosTermCount>(r2, Trig::cosTerms);
+              const __m256d sinX = _mm256_blendv_pd(sinR, cosR, odd);
+              return _mm256_mul_pd(sinX, sinX);
+          }
+
+          __attribute__((target("avx2,fma")))
+          __m256d avx2AbsCos(__m256d x)
+          {
+              __m256d r;
+              const __m256d odd = avx2Reduce(x, r);
+              const __m256d r2 = _mm256_mul_pd(r, r);
+              const __m256d sinR = _mm256_mul_pd(r, avx2Polynomial<sinTermCount>(r2, Trig::sinTerms));
+              const __m256d cosR = avx2Polynomial<cosTermCount>(r2, Trig::cosTerms);
+              const __m256d cosX = _mm256_blendv_pd(cosR, sinR, odd);
+              return _mm256_andnot_pd(avx2Set(-0.0), cosX);
+          }
+
+          // asin(s) for s in [0,1].
+          __attribute__((target("avx2,fma")))
+          __m256d avx2Asin(__m256d s)
+          {
+              const __m256d one = avx2Set(1);
+              const __m256d large = _mm256_cmp_pd(s, avx2Set(0.5), _CMP_GT_OQ);
+              const __m256d t = _mm256_blendv_pd(s, _mm256_sqrt_pd(_mm256_mul_pd(_mm256_sub_pd(one, s), avx2Set(0.5))), large);
+              const __m256d cosT = _mm256_sqrt_pd(_mm256_fnmadd_pd(t, t, one));
+              const __m256d u = _mm256_div_pd(t, _mm256_sqrt_pd(_mm256_fmadd_pd(cosT, avx2Set(2), avx2Set(2))));
+              const __m256d asinT = _mm256_mul_pd(_mm256_add_pd(u, u), avx2Polynomial<asinTermCount>(_mm256_mul_pd(u, u), Trig::asinTerms));
+              return _mm256_blendv_pd(asinT, _mm256_fnmadd_pd(asinT, avx2Set(2), avx2Set(halfPiHigh)), large);
+          }
+
+          __attribute__((target("avx2,fma")))
+          void avx2Pairwise(const degrees * lat1s, const degrees * lon1s,
+                            const degrees * lat2s, const degrees * lon2s,
+                            metres * out, std::size_t n)
+          {
+              const __m256d piRadians = avx2Set(pi);
+              const __m256d halfRotationDegrees = avx2Set(halfRotation);
+              const __m256d half = avx2Set(0.5);
+              const __m256d diameter = avx2Set(2 * Earth::meanRadius);
+
+              std::size_t i = 0;
+              for (; i + 4 <= n; i += 4)
+              {
+                  const __m256d lat1 = _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(lat1s + i), piRadians), halfRotationDegrees);
+                  const __m256d lat2 = _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(lat2s + i), piRadians), halfRotationDegrees);
+                  const __m256d lon1 = _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(lon1s + i), piRadians), halfRotationDegrees);
+                  const __m256d lon2 = _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(lon2s + i), piRadians), halfRotationDegrees);
+
+                  const __m256d cosProduct = _mm256_mul_pd(avx2AbsCos(lat1), avx2AbsCos(lat2));
+                  __m256d h = _mm256_fmadd_pd(cosProduct, avx2SinSqr(_mm256_mul_pd(_mm256_sub_pd(lon2, lon1), half)),
+                                              avx2SinSqr(_mm256_mul_pd(_mm256_sub_pd(lat2, lat1), half)));
+                  h = _mm256_min_pd(h, avx2Set(1));
+                  _mm256_storeu_pd(out + i, _mm256_mul_pd(diameter, avx2Asin(_mm256_sqrt_pd(h))));
+              }
+              scalarPairwise(lat1s + i, lon1s + i, lat2s + i, lon2s + i, out + i, n - i);
+          }
+
+// GCC 12 warns about the deliberately undefined pass-through operands inside the AVX-512 intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+          __attribute__((target("avx512f")))
+          __m512d avx512Set(double x)
+          {
+              return _mm512_set1_pd(x);
+          }
+
+          template <std::size_t N>
+          __attribute__((target("avx512f")))
+          __m512d avx512Polynomial(__m512d x, const double * coefficients)
+          {
+              __m512d result = avx512Set(coefficients[N-1]);
+              for (std::size_t i = N-1; i-- > 0; )
+              {
+                  result = _mm512_fmadd_pd(result, x, avx512Set(coefficients[i]));
+              }
+              return result;
+          }
+
+          // Reduces x to r, returning a mask of the lanes where n is odd.
+          __attribute__((target("avx512f")))
+          __mmask8 avx512Reduce(__m512d x, __m512d & r)
+          {
+              const __m512d n = _mm512_roundscale_pd(_mm512_mul_pd(x, avx512Set(1/halfPiHigh)),
+                                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+              r = _mm512_fnmadd_pd(n, avx512Set(halfPiHigh), x);
+              r = _mm512_fnmadd_pd(n, avx512Set(halfPiLow), r);
+              const __m512d half = _mm512_mul_pd(n, avx512Set(0.5));
+              return _mm512_cmp_pd_mask(_mm512_roundscale_pd(half, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC), half, _CMP_NEQ_OQ);
+          }
+
+          __attribute__((target("avx512f")))
+          __m512d avx512SinSqr(__m512d x)
+          {
+              __m512d r;
+              const __mmask8 odd = avx512Reduce(x, r);
+              const __m512d r2 = _mm512_mul_pd(r, r);
+              const __m512d sinR = _mm512_mul_pd(r, avx512Polynomial<sinTermCount>(r2, Trig::sinTerms));
+              const __m512d cosR = avx512Polynomial<cosTermCount>(r2, Trig::cosTerms);
+              const __m512d sinX = _mm512_mask_blend_pd(odd, sinR, cosR);
+              return _mm512_mul_pd(sinX, sinX);
+          }
+
+          __attribute__((target("avx512f")))
+          __m512d avx512AbsCos(__m512d x)
+          {
+              __m512d r;
+              const __mmask8 odd = avx512Reduce(x, r);
+              const __m512d r2 = _mm512_mul_pd(r, r);
+              const __m512d sinR = _mm512_mul_pd(r, avx512Polynomial<sinTermCount>(r2, Trig::sinTerms));
+              const __m512d cosR = avx512Polynomial<cosTermCount>(r2, Trig::cosTerms);
+              return _mm512_abs_pd(_mm512_mask_blend_pd(odd, cosR, sinR));
+          }
+
+          // asin(s) for s in [0,1].
+          __attribute__((target("avx512f")))
+          __m512d avx512Asin(__m512d s)
+          {
+              const __m512d one = avx512Set(1);
+              const __mmask8 large = _mm512_cmp_pd_mask(s, avx512Set(0.5), _CMP_GT_OQ);
+              const __m512d t = _mm512_mask_blend_pd(large, s, _mm512_sqrt_pd(_mm512_mul_pd(_mm512_sub_pd(one, s), avx512Set(0.5))));
+              const __m512d cosT = _mm512_sqrt_pd(_mm512_fnmadd_pd(t, t, one));
+              const __m512d u = _mm512_div_pd(t, _mm512_sqrt_pd(_mm512_fmadd_pd(cosT, avx512Set(2), avx512Set(2))));
+              const __m512d asinT = _mm512_mul_pd(_mm512_add_pd(u, u), avx512Polynomial<asinTermCount>(_mm512_mul_pd(u, u), Trig::asinTerms));
+              return _mm512_mask_blend_pd(large, asinT, _mm512_fnmadd_pd(asinT, avx512Set(2), avx512Set(halfPiHigh)));
+          }
+
+          __attribute__((target("avx512f")))
+          void avx512Pairwise(const degrees * lat1s, const degrees * lon1s,
+                              const degrees * lat2s, const degrees * lon2s,
+                              metres * out, std::size_t n)
+          {
+              const __m512d piRadians = avx512Set(pi);
+              const __m512d halfRotationDegrees = avx512Set(halfRotation);
+              const __m512d half = avx512Set(0.5);
+              const __m512d diameter = avx512Set(2 * Earth::meanRadius);
+
+              std::size_t i = 0;
+              for (; i + 8 <= n; i += 8)
+              {
+                  const __m512d lat1 = _mm512_div_pd(_mm512_mul_pd(_mm512_loadu_pd(lat1s + i), piRadians), halfRotationDegrees);
+                  const __m512d lat2 = _mm512_div_pd(_mm512_mul_pd(_mm512_loadu_pd(lat2s + i), piRadians), halfRotationDegrees);
+                  const __m512d lon1 = _mm512_div_pd(_mm512_mul_pd(_mm512_loadu_pd(lon1s + i), piRadians), halfRotationDegrees);
+                  const __m512d lon2 = _mm512_div_pd(_mm512_mul_pd(_mm512_loadu_pd(lon2s + i), piRadians), halfRotationDegrees);
+
+                  const __m512d cosProduct = _mm512_mul_pd(avx512AbsCos(lat1), avx512AbsCos(lat2));
+                  __m512d h = _mm512_fmadd_pd(cosProduct, avx512SinSqr(_mm512_mul_pd(_mm512_sub_pd(lon2, lon1), half)),
+                                              avx512SinSqr(_mm512_mul_pd(_mm512_sub_pd(lat2, lat1), half)));
+                  h = _mm512_min_pd(h, avx512Set(1));
+                  _mm512_storeu_pd(out + i, _mm512_mul_pd(diameter, avx512Asin(_mm512_sqrt_pd(h))));
+              }
+              scalarPairwise(lat1s + i, lon1s + i, lat2s + i, lon2s + i, out + i, n - i);
+          }
+
+#pragma GCC diagnostic pop
+#endif
+
+          const Kernels scalar = { "scalar", scalarPairwise };
+#ifdef GPS_BATCHDISTANCE_X86
+          const Kernels avx2 = { "AVX2", avx2Pairwise };
+          const Kernels avx512 = { "AVX-512", avx512Pairwise };
+#endif
+      }
+
+      const Kernels & scalarKernels()
+      {
+          return scalar;
+      }
+
+      std::vector<const Kernels *> availableKernels()
+      {
+          std::vector<const Kernels *> kernels = { &scalar };
+#ifdef GPS_BATCHDISTANCE_X86
+          __builtin_cpu_init();
+          if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) kernels.push_back(&avx2);
+          if (__builtin_cpu_supports("avx512f")) kernels.push_back(&avx512);
+#endif
+          return kernels;
+      }
+
+      const Kernels & bestKernels()
+      {
+          static const Kernels & best = *availableKernels().back();
+          return best;
+      }
+
+      void horizontalDistances(const degrees * lat1, const degrees * lon1,
+                               const degrees * lat2, const degrees * lon2,
+                               metres * out, std::size_t n)
+      {
+          static const Kernels & best = bestKernels();
+          best.pairwise(lat1, lon1, lat2, lon2, out, n);
+      }
+
+      void consecutiveDistances(const degrees * lats, const degrees * lons, metres * out, std::size_t n)
+      {
+          if (n < 2) return;
+          horizontalDistances(lats, lons, lats + 1, lons + 1, out, n - 1);
+      }
+
+      std::vector<metres> consecutiveDistances(const std::vector<Position> & positions)
+      {
+          std::vector<degrees> lats;
+          std::vector<degrees> lons;
+          lats.reserve(positions.size());
+          lons.reserve(positions.size());
+          for (const Position & position : positions)
+          {
+              lats.push_back(position.latitude());
+              lons.push_back(position.longitude());
+          }
+
+          std::vector<metres> distances(positions.empty() ? 0 : positions.size() - 1);
+          consecutiveDistances(lats.data(), lons.data(), distances.data(), positions.size());
+          return distances;
+      }
+  }
+}
@@ -0,0 +1,340 @@
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef GPS_HAVE_ZLIB
+  #include <zlib.h>
+#endif
+#ifdef GPS_HAVE_ZSTD
+  #include <zstd.h>
+#endif
+
+#include "compressedInput.h"
+
+namespace GPS
+{
+  namespace
+  {
+      const unsigned char gzipMagic[] = { 0x1F, 0x8B };
+      const unsigned char zstdMagic[] = { 0x28, 0xB5, 0x2F, 0xFD };
+
+      template <std::size_t N>
+      bool startsWith(std::string_view bytes, const unsigned char (&magic)[N])
+      {
+          if (bytes.size() < N) return false;
+          for (std::size_t i = 0; i < N; ++i)
+          {
+              if (static_cast<unsigned char>(bytes[i]) != magic[i]) return false;
+          }
+          return true;
+      }
+
+      // The size of the compressed reads, and of the decompressed blocks passed to the reader.
+      const std::size_t compressedChunkSize = 64 * 1024;
+      const std::size_t blockSize = 256 * 1024;
+
+      // How far the decompression thread may get ahead of the reader.
+      const std::size_t maxBlocksAhead = 4;
+
+      /* Receives decompressed data from the decompression thread.
+       * Returns false if the reader has gone away, so decompression should stop.
+       */
+      using BlockSink = std::function<bool(std::vector<char> &&)>;
+
+#ifdef GPS_HAVE_ZLIB
+      // Decompresses a gzip file, including one made of several concatenated members.
+      void gunzip(std::istream & input, const BlockSink & sink)
+      {
+          z_stream stream = {};
+          if (inflateInit2(&stream, 15 + 16) != Z_OK) throw std::domain_error("Cannot initialise gzip decompression.");
+
+          std::vector<char> compressed(compressedChunkSize);
+          std::vector<char> block(blockSize);
+          stream.next_out = reinterpret_cast<Bytef *>(block.data());
+          stream.avail_out = static_cast<uInt>(block.size());
+
+          int status = Z_OK;
+          bool atMemberEnd = false;
+          try
+          {
+              while (input.read(compressed.data(), compressed.size()) || input.gcount() > 0)
+              {
+                  stream.next_in = reinterpret_cast<Bytef *>(compressed.data());
+                  stream.avail_in = static_cast<uInt>(input.gcount());
+                  while (stream.avail_in > 0)
+                  {
+                      if (atMemberEnd)
+                      {
+                          inflateReset(&stream);
+                          atMemberEnd = false;
+                      }
+                      status = inflate(&stream, Z_NO_FLUSH);
+                      if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+                      {
+                          throw std::domain_error("Corrupt gzip data.");
+                      }
+                      atMemberEnd = (status == Z_STREAM_END);
+
+                      if (stream.avail_out == 0)
+                      {
+                          if (! sink(std::move(block)))
+                          {
+                              inflateEnd(&stream);
+                              return;
+                          }
+                          block.assign(blockSize, '\0');
+                          stream.next_out = reinterpret_cast<Bytef *>(block.data());
+                          stream.avail_out = static_cast<uInt>(block.size());
+                      }
+                  }
+              }
+              if (! atMemberEnd) throw std::domain_error("Truncated gzip data.");
+
+              block.resize(block.size() - stream.avail_out);
+              if (! block.empty()) sink(std::move(block));
+          }
+          catch (...)
+          {
+              inflateEnd(&stream);
+              throw;
+          }
+          inflateEnd(&stream);
+      }
+#endif
+
+#ifdef GPS_HAVE_ZSTD
+      void unzstd(std::istream & input, const BlockSink & sink)
+      {
+          ZSTD_DStream * stream = ZSTD_createDStream();
+          if (stream == nullptr) throw std::domain_error("Cannot initialise zstd decompression.");
+
+          std::vector<char> compressed(compressedChunkSize);
+          std::vector<char> block(blockSize);
+          ZSTD_outBuffer output = { block.data(), block.size(), 0 };
+
+          std::size_t status = 0;
+          try
+          {
+              while (input.read(compressed.data(), compressed.size()) || input.gcount() > 0)
+              {
+                  ZSTD_inBuffer in = { compressed.data(), static_cast<std::size_t>(input.gcount()), 0 };
+                  while (in.pos < in.size)
+                  {
+                      status = ZSTD_decompressStream(stream, &output, &in);
+                      if (ZSTD_isError(status)) throw std::domain_error(std::string("Corrupt zstd data: ") + ZSTD_getErrorName(status));
+
+                      if (output.pos == output.size)
+                      {
+                          if (! sink(std::move(block)))
+                          {
+                              ZSTD_freeDStream(stream);
+                              return;
+                          }
+                          block.assign(blockSize, '\0');
+                          output = { block.data(), block.size(), 0 };
+                      }
+                  }
+              }
+              // A non-zero status means that the final frame is incomplete.
+              if (status != 0) throw std::domain_error("Truncated zstd data.");
+
+              block.resize(output.pos);
+              if (! block.empty()) sink(std::move(block));
+          }
+          catch (...)
+          {
+              ZSTD_freeDStream(stream);
+              throw;
+          }
+          ZSTD_freeDStream(stream);
+      }
+#endif
+
+      /* A stream buffer fed with blocks of decompressed data by a background thread.
+       * The thread is at most 'maxBlocksAhead' blocks ahead of the reader.
+       */
+      class PipelinedBuffer : public std::streambuf
+      {
+        public:
+          PipelinedBuffer(const std::string & filePath, Compression format)
+              : input(filePath, std::ios::binary)
+          {
+              if (! input.good()) throw std::invalid_argument("Error opening source file '" + filePath + "'.");
+              decompressor = std::thread([this, format]() { decompress(format); });
+          }
+
+          ~PipelinedBuffer() override
+          {
+              {
+                  const std::lock_guard<std::mutex> lock(mutex);
+                  readerGone = true;
+              }
+              blockTaken.notify_all();
+              decompressor.join();
+          }
+
+          // Throws a std::domain_error if decompression failed.
+          void checkDecompression() const
+          {
+              const std::lock_guard<std::mutex> lock(mutex);
+              if (failure) std::rethrow_exception(failure);
+          }
+
+        protected:
+          int_type underflow() override
+          {
+              std::unique_lock<std::mutex> lock(mutex);
+              blockAdded.wait(lock, [this]() { return ! blocks.empty() || finished; });
+              if (blocks.empty()) return traits_type::eof();
+
+              current = std::move(blocks.front());
+              blocks.pop_front();
+              lock.unlock();
+              blockTaken.notify_one();
+
+              setg(current.data(), current.data(), current.data() + current.size());
+              return traits_type::to_int_type(current.front());
+          }
+
+        private:
+          std::ifstream input;
+          std::thread decompressor;
+
+          mutable std::mutex mutex;
+          std::condition_variable blockAdded;
+          std::condition_variable blockTaken;
+          std::deque<std::vector<char>> blocks;
+          bool finished = false;
+          bool readerGone = false;
+          std::exception_ptr failure;
+
+          std::vector<char> current; // the block being read
+
+          // Runs on the background thread.
+          void decompress(Compression format)
+          {
+              const BlockSink sink = [this](std::vector<char> && block)
+              {
+                  std::unique_lock<std::mutex> lock(mutex);
+                  blockTaken.wait(lock, [this]() { return blocks.size() < maxBlocksAhead || readerGone; });
+                  if (readerGone) return false;
+                  blocks.push_back(std::move(block));
+                  lock.unlock();
+                  blockAdded.notify_one();
+                  return true;
+              };
+
+              try
+              {
+                  switch (format)
+                  {
+#ifdef GPS_HAVE_ZLIB
+                      case Compression::gzip: gunzip(input, sink); break;
+#endif
+#ifdef GPS_HAVE_ZSTD
+                      case Compression::zstd: unzstd(input, sink); break;
+#endif
+                      default: throw std::domain_error("Unsupported compression format.");
+                  }
+              }
+              catch (...)
+              {
+                  const std::lock_guard<std::mutex> lock(mutex);
+                  failure = std::current_exception();
+              }
+
+              {
+                  const std::lock_guard<std::mutex> lock(mutex);
+                  finished = true;
+              }
+              blockAdded.notify_one();
+          }
+      };
+  }
+
+  Compression detectCompression(std::string_view leadingBytes)
+  {
+      if (startsWith(leadingBytes, gzipMagic)) return Compression::gzip;
+      if (startsWith(leadingBytes, zstdMagic)) return Compression::zstd;
+      return Compression::none;
+  }
+
+  Compression compressionOf(const std::string & filePath)
+  {
+      /* Reading from a FIFO or device would consume its leading bytes (and more, into the
+       * stream's buffer), so they are not available to the reader, and are taken to be
+       * uncompressed.
+       */
+      std::error_code error;
+      const std::filesystem::file_status status = std::filesystem::status(filePath, error);
+      if (! error && std::filesystem::exists(status) && ! std::filesystem::is_regular_file(status) &&
+          ! std::filesystem::is_directory(status))
+      {
+          return Compression::none;
+      }
+
+      std::ifstream file(filePath, std::ios::binary);
+      if (! file.good()) throw std::invalid_argument("Error opening source file '" + filePath + "'.");
+
+      char leadingBytes[sizeof(zstdMagic)];
+      file.read(leadingBytes, sizeof(leadingBytes));
+      return detectCompression(std::string_view(leadingBytes, static_cast<std::size_t>(file.gcount())));
+  }
+
+  bool canDecompress(Compression format)
+  {
+      switch (format)
+      {
+          case Compression::none: return true;
+#ifdef GPS_HAVE_ZLIB
+          case Compression::gzip: return true;
+#endif
+#ifdef GPS_HAVE_ZSTD
+          case Compression::zstd: return true;
+#endif
+          default: return false;
+      }
+  }
+
+  InputFile::InputFile(const std::string & filePath)
+      : std::istream(nullptr), format(compressionOf(filePath))
+  {
+      if (! canDecompress(format))
+      {
+          throw std::domain_error("Source file '" + filePath + "' is compressed in a format that is not supported by this build.");
+      }
+
+      if (format == Compression::none)
+      {
+          auto fileBuffer = std::make_unique<std::filebuf>();
+          if (fileBuffer->open(filePath, std::ios::in | std::ios::binary) == nullptr)
+          {
+              throw std::invalid_argument("Error opening source file '" + filePath + "'.");
+          }
+          buffer = std::move(fileBuffer);
+      }
+      else
+      {
+          buffer = std::make_unique<PipelinedBuffer>(filePath, format);
+      }
+      rdbuf(buffer.get());
+  }
+
+  InputFile::~InputFile() = default;
+
+  Compression InputFile::compression() const
+  {
+      return format;
+  }
+
+  void InputFile::checkDecompression() const
+  {
+      if (format != Compression::none) static_cast<const PipelinedBuffer &>(*buffer).checkDecompression();
+  }
+}
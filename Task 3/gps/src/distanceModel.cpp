@@ -0,0 +1,123 @@
+#include <cmath>
+
+#include "geometry.h"
+#include "earth.h"
+#include "batchDistance.h"
+#include "distanceModel.h"
+
+namespace GPS
+{
+  namespace DistanceModels
+  {
+      namespace
+      {
+          // The longitude difference from p1 to p2, in the range [-pi,pi].
+          radians longitudeDifference(const PreparedPosition & p1, const PreparedPosition & p2)
+          {
+              radians deltaLon = p2.longitudeRadians() - p1.longitudeRadians();
+              if (deltaLon > pi) deltaLon -= 2 * pi;
+              if (deltaLon < -pi) deltaLon += 2 * pi;
+              return deltaLon;
+          }
+
+          metres equirectangularDistance(const PreparedPosition & p1, const PreparedPosition & p2)
+          {
+              const double x = longitudeDifference(p1,p2) * (p1.cosLatitude() + p2.cosLatitude()) / 2;
+              const double y = p2.latitudeRadians() - p1.latitudeRadians();
+              return Earth::meanRadius * pythagoras(x,y);
+          }
+
+          metres flatEarthDistance(const PreparedPosition & p1, const PreparedPosition & p2)
+          {
+              const double x = longitudeDifference(p1,p2) * p1.cosLatitude();
+              const double y = p2.latitudeRadians() - p1.latitudeRadians();
+              return Earth::meanRadius * pythagoras(x,y);
+          }
+
+          /* See: T. Vincenty, "Direct and inverse solutions of geodesics on the ellipsoid with
+           * application of nested equations", Survey Review XXIII (176), 1975.
+           */
+          metres vincentyDistance(const PreparedPosition & p1, const PreparedPosition & p2)
+          {
+              const double a = Earth::wgs84SemiMajorAxis;
+              const double f = Earth::wgs84Flattening;
+              const double b = (1 - f) * a;
+
+              const unsigned int maxIterations = 200;
+              const double convergenceThreshold = 1e-12;
+
+              // Reduced latitudes.
+              const double tanU1 = (1 - f) * std::tan(p1.latitudeRadians());
+              const double tanU2 = (1 - f) * std::tan(p2.latitudeRadians());
+              const double cosU1 = 1 / std::sqrt(1 + tanU1*tanU1);
+              const double cosU2 = 1 / std::sqrt(1 + tanU2*tanU2);
+              const double sinU1 = tanU1 * cosU1;
+              const double sinU2 = tanU2 * cosU2;
+
+              const radians L = longitudeDifference(p1,p2);
+              radians lambda = L;
+
+              double sinSigma, cosSigma, sigma, cosSqAlpha, cos2SigmaM;
+              for (unsigned int iteration = 0; ; ++iteration)
+              {
+                  if (iteration == maxIterations)
+                  {
+                      // Nearly antipodal points, where the iteration can fail to converge.
+                      return PreparedPosition::horizontalDistanceBetween(p1, p2);
+                  }
+
+                  const double sinLambda = std::sin(lambda);
+                  const double cosLambda = std::cos(lambda);
+                  sinSigma = pythagoras(cosU2 * sinLambda, cosU1 * sinU2 - sinU1 * cosU2 * cosLambda);
+                  if (sinSigma == 0) return 0; // coincident points
+
+                  cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+                  sigma = std::atan2(sinSigma, cosSigma);
+                  const double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+                  cosSqAlpha = 1 - sinAlpha * sinAlpha;
+                  cos2SigmaM = (cosSqAlpha != 0) ? cosSigma - 2 * sinU1 * sinU2 / cosSqAlpha : 0; // 0 on the equator
+
+                  const double C = f / 16 * cosSqAlpha * (4 + f * (4 - 3 * cosSqAlpha));
+                  const radians previousLambda = lambda;
+                  lambda = L + (1 - C) * f * sinAlpha
+                               * (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)));
+
+                  if (std::abs(lambda - previousLambda) < convergenceThreshold) break;
+              }
+
+              const double uSq = cosSqAlpha * (a*a - b*b) / (b*b);
+              const double A = 1 + uSq / 16384 * (4096 + uSq * (-768 + uSq * (320 - 175 * uSq)));
+              const double B = uSq / 1024 * (256 + uSq * (-128 + uSq * (74 - 47 * uSq)));
+              const double deltaSigma = B * sinSigma * (cos2SigmaM + B / 4 * (cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)
+                                            - B / 6 * cos2SigmaM * (-3 + 4 * sinSigma * sinSigma) * (-3 + 4 * cos2SigmaM * cos2SigmaM)));
+              return b * A * (sigma - deltaSigma);
+          }
+
+          const DistanceModel haversineModel = { "haversine", PreparedPosition::horizontalDistanceBetween,
+                                                 BatchDistance::horizontalDistances };
+          const DistanceModel equirectangularModel = { "equirectangular", equirectangularDistance, nullptr };
+          const DistanceModel flatEarthModel = { "flat earth", flatEarthDistance, nullptr };
+          const DistanceModel vincentyModel = { "Vincenty", vincentyDistance, nullptr };
+      }
+
+      const DistanceModel & haversine()
+      {
+          return haversineModel;
+      }
+
+      const DistanceModel & equirectangular()
+      {
+          return equirectangularModel;
+      }
+
+      const DistanceModel & flatEarth()
+      {
+          return flatEarthModel;
+      }
+
+      const DistanceModel & vincenty()
+      {
+          return vincentyModel;
+      }
+  }
+}
@@ -0,0 +1,245 @@
+#include "byteScan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define NMEA_BYTESCAN_X86
+  #include <immintrin.h>
+#endif
+
+namespace NMEA
+{
+  namespace ByteScan
+  {
+      namespace
+      {
+          bool isDelimiter(char c)
+          {
+              return c == fieldDelimiter || c == checksumDelimiter || c == sentenceStart || c == lineEnd;
+          }
+
+          unsigned char scalarXorReduce(const char * data, std::size_t length)
+          {
+              unsigned char total = 0;
+              for (std::size_t i = 0; i < length; ++i)
+              {
+                  total ^= static_cast<unsigned char>(data[i]);
+              }
+              return total;
+          }
+
+          std::size_t scalarFindDelimiter(const char * data, std::size_t length)
+          {
+              for (std::size_t i = 0; i < length; ++i)
+              {
+                  if (isDelimiter(data[i])) return i;
+              }
+              return length;
+          }
+
+          std::size_t scalarFindDelimiterXor(const char * data, std::size_t length, unsigned char & total)
+          {
+              for (std::size_t i = 0; i < length; ++i)
+              {
+                  if (isDelimiter(data[i])) return i;
+                  total ^= static_cast<unsigned char>(data[i]);
+              }
+              return length;
+          }
+
+#ifdef NMEA_BYTESCAN_X86
+          /* The SIMD kernels process whole 16 or 32 byte blocks using unaligned loads,
+           * and hand any remaining tail over to the scalar kernels, so they never read
+           * outside the buffer.
+           */
+
+          // XOR together the 16 bytes of a vector.
+          __attribute__((target("sse2")))
+          unsigned char foldXor(__m128i v)
+          {
+              v = _mm_xor_si128(v, _mm_srli_si128(v, 8));
+              v = _mm_xor_si128(v, _mm_srli_si128(v, 4));
+              v = _mm_xor_si128(v, _mm_srli_si128(v, 2));
+              v = _mm_xor_si128(v, _mm_srli_si128(v, 1));
+              return static_cast<unsigned char>(_mm_cvtsi128_si32(v));
+          }
+
+          __attribute__((target("sse2")))
+          unsigned char sse2XorReduce(const char * data, std::size_t length)
+          {
+              __m128i total = _mm_setzero_si128();
+              std::size_t i = 0;
+              for (; i + 16 <= length; i += 16)
+              {
+                  total = _mm_xor_si128(total, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+              }
+              return foldXor(total) ^ scalarXorReduce(data + i, length - i);
+          }
+
+          __attribute__((target("sse2")))
+          std::size_t sse2FindDelimiter(const char * data, std::size_t length)
+          {
+              const __m128i commas  = _mm_set1_epi8(fieldDelimiter);
+              const __m128i stars   = _mm_set1_epi8(checksumDelimiter);
+              const __m128i dollars = _mm_set1_epi8(sentenceStart);
+              const __m128i lineEnds = _mm_set1_epi8(lineEnd);
+
+              std::size_t i = 0;
+              for (; i + 16 <= length; i += 16)
+              {
+                  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                  const __m128i matches = _mm_or_si128(
+                      _mm_or_si128(_mm_cmpeq_epi8(block, commas), _mm_cmpeq_epi8(block, stars)),
+                      _mm_or_si128(_mm_cmpeq_epi8(block, dollars), _mm_cmpeq_epi8(block, lineEnds)));
+                  const int mask = _mm_movemask_epi8(matches);
+                  if (mask != 0) return i + __builtin_ctz(static_cast<unsigned int>(mask));
+              }
+              return i + scalarFindDelimiter(data + i, length - i);
+          }
+
+          __attribute__((target("sse2")))
+          std::size_t sse2FindDelimiterXor(const char * data, std::size_t length, unsigned char & total)
+          {
+              const __m128i commas  = _mm_set1_epi8(fieldDelimiter);
+              const __m128i stars   = _mm_set1_epi8(checksumDelimiter);
+              const __m128i dollars = _mm_set1_epi8(sentenceStart);
+              const __m128i lineEnds = _mm_set1_epi8(lineEnd);
+              const __m128i byteIndices = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+              __m128i blockTotal = _mm_setzero_si128();
+              std::size_t i = 0;
+              for (; i + 16 <= length; i += 16)
+              {
+                  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                  const __m128i matches = _mm_or_si128(
+                      _mm_or_si128(_mm_cmpeq_epi8(block, commas), _mm_cmpeq_epi8(block, stars)),
+                      _mm_or_si128(_mm_cmpeq_epi8(block, dollars), _mm_cmpeq_epi8(block, lineEnds)));
+                  const int mask = _mm_movemask_epi8(matches);
+                  if (mask != 0)
+                  {
+                      // Only the bytes before the delimiter are XORed.
+                      const int offset = __builtin_ctz(static_cast<unsigned int>(mask));
+                      const __m128i before = _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(offset)), byteIndices);
+                      total ^= foldXor(_mm_xor_si128(blockTotal, _mm_and_si128(block, before)));
+                      return i + offset;
+                  }
+                  blockTotal = _mm_xor_si128(blockTotal, block);
+              }
+              total ^= foldXor(blockTotal);
+              return i + scalarFindDelimiterXor(data + i, length - i, total);
+          }
+
+          __attribute__((target("avx2")))
+          unsigned char avx2XorReduce(const char * data, std::size_t length)
+          {
+              __m256i total = _mm256_setzero_si256();
+              std::size_t i = 0;
+              for (; i + 32 <= length; i += 32)
+              {
+                  total = _mm256_xor_si256(total, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+              }
+              const __m128i halves = _mm_xor_si128(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+              return foldXor(halves) ^ sse2XorReduce(data + i, length - i);
+          }
+
+          __attribute__((target("avx2")))
+          std::size_t avx2FindDelimiter(const char * data, std::size_t length)
+          {
+              const __m256i commas  = _mm256_set1_epi8(fieldDelimiter);
+              const __m256i stars   = _mm256_set1_epi8(checksumDelimiter);
+              const __m256i dollars = _mm256_set1_epi8(sentenceStart);
+              const __m256i lineEnds = _mm256_set1_epi8(lineEnd);
+
+              std::size_t i = 0;
+              for (; i + 32 <= length; i += 32)
+              {
+                  const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                  const __m256i matches = _mm256_or_si256(
+                      _mm256_or_si256(_mm256_cmpeq_epi8(block, commas), _mm256_cmpeq_epi8(block, stars)),
+                      _mm256_or_si256(_mm256_cmpeq_epi8(block, dollars), _mm256_cmpeq_epi8(block, lineEnds)));
+                  const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(matches));
+                  if (mask != 0) return i + __builtin_ctz(mask);
+              }
+              return i + sse2FindDelimiter(data + i, length - i);
+          }
+
+          __attribute__((target("avx2")))
+          std::size_t avx2FindDelimiterXor(const char * data, std::size_t length, unsigned char & total)
+          {
+              const __m256i commas  = _mm256_set1_epi8(fieldDelimiter);
+              const __m256i stars   = _mm256_set1_epi8(checksumDelimiter);
+              const __m256i dollars = _mm256_set1_epi8(sentenceStart);
+              const __m256i lineEnds = _mm256_set1_epi8(lineEnd);
+              const __m256i byteIndices = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                           16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+
+              __m256i blockTotal = _mm256_setzero_si256();
+              std::size_t i = 0;
+              for (; i + 32 <= length; i += 32)
+              {
+                  const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                  const __m256i matches = _mm256_or_si256(
+                      _mm256_or_si256(_mm256_cmpeq_epi8(block, commas), _mm256_cmpeq_epi8(block, stars)),
+                      _mm256_or_si256(_mm256_cmpeq_epi8(block, dollars), _mm256_cmpeq_epi8(block, lineEnds)));
+                  const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(matches));
+                  if (mask != 0)
+                  {
+                      const int offset = __builtin_ctz(mask);
+                      const __m256i before = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(offset)), byteIndices);
+                      blockTotal = _mm256_xor_si256(blockTotal, _mm256_and_si256(block, before));
+                      total ^= foldXor(_mm_xor_si128(_mm256_castsi256_si128(blockTotal), _mm256_extracti128_si256(blockTotal, 1)));
+                      return i + offset;
+                  }
+                  blockTotal = _mm256_xor_si256(blockTotal, block);
+              }
+              total ^= foldXor(_mm_xor_si128(_mm256_castsi256_si128(blockTotal), _mm256_extracti128_si256(blockTotal, 1)));
+              return i + sse2FindDelimiterXor(data + i, length - i, total);
+          }
+#endif
+
+          const Kernels scalar = { "scalar", scalarXorReduce, scalarFindDelimiter, scalarFindDelimiterXor };
+#ifdef NMEA_BYTESCAN_X86
+          const Kernels sse2 = { "SSE2", sse2XorReduce, sse2FindDelimiter, sse2FindDelimiterXor };
+          const Kernels avx2 = { "AVX2", avx2XorReduce, avx2FindDelimiter, avx2FindDelimiterXor };
+#endif
+      }
+
+      const Kernels & scalarKernels()
+      {
+          return scalar;
+      }
+
+      std::vector<const Kernels *> availableKernels()
+      {
+          std::vector<const Kernels *> kernels = { &scalar };
+#ifdef NMEA_BYTESCAN_X86
+          __builtin_cpu_init();
+          if (__builtin_cpu_supports("sse2")) kernels.push_back(&sse2);
+          if (__builtin_cpu_supports("sse2") && __builtin_cpu_supports("avx2")) kernels.push_back(&avx2);
+#endif
+          return kernels;
+      }
+
+      const Kernels & bestKernels()
+      {
+          static const Kernels & best = *availableKernels().back();
+          return best;
+      }
+
+      unsigned char xorReduce(const char * data, std::size_t length)
+      {
+          static const Kernels & best = bestKernels();
+          return best.xorReduce(data, length);
+      }
+
+      std::size_t findDelimiter(const char * data, std::size_t length)
+      {
+          static const Kernels & best = bestKernels();
+          return best.findDelimiter(data, length);
+      }
+
+      std::size_t findDelimiterXor(const char * data, std::size_t length, unsigned char & total)
+      {
+          static const Kernels & best = bestKernels();
+          return best.findDelimiterXor(data, length, total);
+      }
+  }
+}
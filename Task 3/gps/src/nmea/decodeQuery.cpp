@@ -0,0 +1,35 @@
+#include "decodeQuery.h"
+#include "positionBatch.h"
+
+namespace NMEA
+{
+  bool DecodeQuery::restrictsTime() const
+  {
+      return earliestTime > -std::numeric_limits<double>::infinity()
+          || latestTime < std::numeric_limits<double>::infinity();
+  }
+
+  bool DecodeQuery::acceptsTime(double timeOfDay) const
+  {
+      // Comparisons with NaN (an unknown time) are false.
+      return timeOfDay >= earliestTime && timeOfDay <= latestTime;
+  }
+
+  bool DecodeQuery::acceptsLatitude(GPS::degrees latitude) const
+  {
+      return latitude >= minLatitude && latitude <= maxLatitude;
+  }
+
+  bool DecodeQuery::acceptsLongitude(GPS::degrees longitude) const
+  {
+      if (minLongitude <= maxLongitude) return longitude >= minLongitude && longitude <= maxLongitude;
+      return longitude >= minLongitude || longitude <= maxLongitude;
+  }
+
+  bool DecodeQuery::acceptsFixQuality(std::uint8_t fixQuality) const
+  {
+      // An unknown fix quality only passes when nothing is required.
+      return minFixQuality == 0
+          || (fixQuality >= minFixQuality && fixQuality != GPS::PositionBatch::unknownFixQuality);
+  }
+}
@@ -0,0 +1,58 @@
+#include "epochFusion.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      // Merges a sentence into a Fix for the same epoch.
+      void merge(Fix & fix, const SentenceView & sentence, const GPS::Position & position)
+      {
+          const bool fromGGA = (sentence.format() == "GGA");
+
+          if (fromGGA && ! fix.hasElevation)
+          {
+              fix.position = position;
+              fix.hasElevation = true;
+          }
+
+          const std::uint8_t quality = fixQuality(sentence);
+          if (quality != GPS::PositionBatch::unknownFixQuality &&
+              (fromGGA || fix.fixQuality == GPS::PositionBatch::unknownFixQuality))
+          {
+              fix.fixQuality = quality;
+          }
+
+          if (! fix.date) fix.date = dateOf(sentence);
+          if (! fix.groundSpeed) fix.groundSpeed = groundSpeedOf(sentence);
+          if (! fix.course) fix.course = courseOf(sentence);
+      }
+  }
+
+  EpochFusion::EpochFusion(FixHandler handler)
+      : handleFix(std::move(handler))
+  {}
+
+  void EpochFusion::add(const SentenceView & sentence, const GPS::Position & position)
+  {
+      const double time = timeOfDay(sentence);
+
+      // NaN times never compare equal, so sentences without times are never merged.
+      if (pending && ! (pending->timeOfDay == time)) finish();
+
+      if (! pending)
+      {
+          pending = Fix{position, false, time, GPS::PositionBatch::unknownFixQuality, {}, {}, {}};
+      }
+      merge(*pending, sentence, position);
+  }
+
+  void EpochFusion::finish()
+  {
+      if (! pending) return;
+
+      // Reset first, in case the handler throws.
+      const Fix fix = *pending;
+      pending.reset();
+      handleFix(fix);
+  }
+}
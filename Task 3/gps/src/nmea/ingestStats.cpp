@@ -0,0 +1,87 @@
+#include <numeric>
+
+#include "ingestStats.h"
+#include "packedFormat.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      double perSecond(std::uint64_t count, std::chrono::nanoseconds elapsed)
+      {
+          const double elapsedSeconds = std::chrono::duration<double>(elapsed).count();
+          return (elapsedSeconds > 0) ? count / elapsedSeconds : 0;
+      }
+  }
+
+  void IngestStats::addAccepted(std::string_view format)
+  {
+      addAccepted(packFormat(format), 1);
+  }
+
+  void IngestStats::addAccepted(std::uint32_t packedFormat, std::uint64_t count)
+  {
+      if (packedFormat != 0)
+      {
+          for (std::size_t i = 0; i < maxFormats; ++i)
+          {
+              if (formats[i] == 0) formats[i] = packedFormat;
+              if (formats[i] == packedFormat)
+              {
+                  formatCounts[i] += count;
+                  return;
+              }
+          }
+      }
+      otherFormatCount += count;
+  }
+
+  std::uint64_t IngestStats::accepted(std::string_view format) const
+  {
+      const std::uint32_t packedFormat = packFormat(format);
+      for (std::size_t i = 0; i < maxFormats && formats[i] != 0; ++i)
+      {
+          if (formats[i] == packedFormat) return formatCounts[i];
+      }
+      return 0;
+  }
+
+  std::uint64_t IngestStats::accepted() const
+  {
+      return std::accumulate(formatCounts.begin(), formatCounts.end(), otherFormatCount);
+  }
+
+  std::uint64_t IngestStats::rejected() const
+  {
+      return malformed + badChecksum + unsupportedFormat + invalidFields;
+  }
+
+  double IngestStats::linesPerSecond() const
+  {
+      return perSecond(linesRead, elapsed);
+  }
+
+  double IngestStats::bytesPerSecond() const
+  {
+      return perSecond(bytesRead, elapsed);
+  }
+
+  IngestStats & IngestStats::operator+=(const IngestStats & other)
+  {
+      linesRead += other.linesRead;
+      bytesRead += other.bytesRead;
+      malformed += other.malformed;
+      badChecksum += other.badChecksum;
+      unsupportedFormat += other.unsupportedFormat;
+      invalidFields += other.invalidFields;
+      filtered += other.filtered;
+      elapsed += other.elapsed;
+
+      for (std::size_t i = 0; i < maxFormats && other.formats[i] != 0; ++i)
+      {
+          addAccepted(other.formats[i], other.formatCounts[i]);
+      }
+      otherFormatCount += other.otherFormatCount;
+      return *this;
+  }
+}
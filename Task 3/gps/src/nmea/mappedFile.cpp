@@ -0,0 +1,76 @@
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define NMEA_MAPPEDFILE_POSIX
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include "mappedFile.h"
+
+namespace NMEA
+{
+  MappedFile::MappedFile(const std::string & filePath)
+  {
+#ifdef NMEA_MAPPEDFILE_POSIX
+      const int fd = ::open(filePath.c_str(), O_RDONLY);
+      if (fd < 0) throw std::invalid_argument("Error opening source file '" + filePath + "'.");
+
+      struct stat fileStatus;
+      if (::fstat(fd, &fileStatus) != 0)
+      {
+          ::close(fd);
+          throw std::invalid_argument("Error reading source file '" + filePath + "'.");
+      }
+      if (S_ISDIR(fileStatus.st_mode))
+      {
+          ::close(fd);
+          throw std::invalid_argument("Source file '" + filePath + "' is a directory.");
+      }
+
+      /* Only regular files can be mapped.  Other files (FIFOs, /dev/stdin) report a size
+       * of zero, as do procfs files, although they are regular files with contents.  So
+       * anything that reports a size of zero is read by the fallback below, which also
+       * copes with files that really are empty.
+       */
+      if (S_ISREG(fileStatus.st_mode) && fileStatus.st_size > 0)
+      {
+          size = static_cast<std::size_t>(fileStatus.st_size);
+          void * mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (mapping != MAP_FAILED)
+          {
+              ::madvise(mapping, size, MADV_SEQUENTIAL);
+              data = static_cast<const char *>(mapping);
+              isMapped = true;
+          }
+      }
+      ::close(fd);
+
+      if (isMapped) return;
+#endif
+      // Fall back to reading the file into memory.
+      std::ifstream file(filePath, std::ios::binary);
+      if (! file.good()) throw std::invalid_argument("Error opening source file '" + filePath + "'.");
+      std::ostringstream contents;
+      contents << file.rdbuf();
+      buffer = contents.str();
+      data = buffer.data();
+      size = buffer.size();
+  }
+
+  MappedFile::~MappedFile()
+  {
+#ifdef NMEA_MAPPEDFILE_POSIX
+      if (isMapped) ::munmap(const_cast<char *>(data), size);
+#endif
+  }
+
+  std::string_view MappedFile::contents() const
+  {
+      return std::string_view(data, size);
+  }
+}
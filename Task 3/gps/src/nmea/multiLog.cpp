@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include "multiLog.h"
+#include "parseNMEA.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      const double secondsPerDay = 24 * 60 * 60;
+
+      /* The merge keys for a file's Positions: time stamps with day rollovers added, and
+       * unknown time stamps replaced by the preceding key.
+       */
+      std::vector<double> mergeKeysOf(const GPS::PositionBatch & positions)
+      {
+          const std::vector<double> & timeStamps = positions.timeStamps();
+          std::vector<double> keys(timeStamps.size());
+          double previous = -std::numeric_limits<double>::infinity();
+          double dayOffset = 0;
+          for (std::size_t i = 0; i < timeStamps.size(); ++i)
+          {
+              if (! std::isnan(timeStamps[i]))
+              {
+                  double key = timeStamps[i] + dayOffset;
+                  if (key < previous - secondsPerDay / 2)
+                  {
+                      dayOffset += secondsPerDay;
+                      key += secondsPerDay;
+                  }
+                  previous = key;
+              }
+              keys[i] = previous;
+          }
+          return keys;
+      }
+
+      struct MergeHead
+      {
+          double key;
+          std::size_t file;
+          std::size_t index;
+
+          // Reversed, so that a std::priority_queue yields the earliest head first.
+          bool operator<(const MergeHead & other) const
+          {
+              if (key != other.key) return key > other.key;
+              return file > other.file;
+          }
+      };
+  }
+
+  std::vector<std::string> logFilesIn(const std::string & directory, const std::string & extension)
+  {
+      std::error_code error;
+      std::filesystem::directory_iterator entries(directory, error);
+      if (error) throw std::invalid_argument("Error reading directory '" + directory + "'.");
+
+      std::vector<std::string> filePaths;
+      for (const std::filesystem::directory_entry & entry : entries)
+      {
+          if (entry.is_regular_file() && (extension.empty() || entry.path().extension() == extension))
+          {
+              filePaths.push_back(entry.path().string());
+          }
+      }
+      std::sort(filePaths.begin(), filePaths.end());
+      return filePaths;
+  }
+
+  std::vector<LogPositions> positionsFromLogs(const std::vector<std::string> & filePaths, unsigned int numThreads)
+  {
+      return positionsFromLogs(filePaths, TalkerSet::gps(), nullptr, numThreads);
+  }
+
+  std::vector<LogPositions> positionsFromLogs(const std::vector<std::string> & filePaths, const TalkerSet & talkers,
+                                              TalkerCounts * talkerCounts, unsigned int numThreads,
+                                              IngestStats * ingestStats)
+  {
+      const auto start = std::chrono::steady_clock::now();
+
+      std::vector<LogPositions> results(filePaths.size());
+      std::vector<TalkerCounts> fileTalkerCounts(talkerCounts != nullptr ? filePaths.size() : 0);
+      std::vector<IngestStats> fileIngestStats(ingestStats != nullptr ? filePaths.size() : 0);
+
+      // Largest files first; a file whose size cannot be read fails when it is decoded.
+      std::vector<std::uintmax_t> sizes(filePaths.size());
+      for (std::size_t i = 0; i < filePaths.size(); ++i)
+      {
+          std::error_code error;
+          sizes[i] = std::filesystem::file_size(filePaths[i], error);
+          if (error) sizes[i] = 0;
+      }
+      std::vector<std::size_t> order(filePaths.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&sizes](std::size_t a, std::size_t b) { return sizes[a] > sizes[b]; });
+
+      if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+      numThreads = static_cast<unsigned int>(std::min<std::size_t>(numThreads, std::max<std::size_t>(1, filePaths.size())));
+
+      // Each worker repeatedly claims the next (largest remaining) file.
+      std::atomic<std::size_t> nextFile{0};
+      std::exception_ptr failure;
+      std::mutex failureMutex;
+      auto worker = [&]()
+      {
+          try
+          {
+              for (std::size_t claimed = nextFile++; claimed < order.size(); claimed = nextFile++)
+              {
+                  const std::size_t i = order[claimed];
+                  results[i].filePath = filePaths[i];
+                  positionsFromLogInto(filePaths[i], results[i].positions, talkers,
+                                       talkerCounts != nullptr ? &fileTalkerCounts[i] : nullptr,
+                                       ingestStats != nullptr ? &fileIngestStats[i] : nullptr);
+              }
+          }
+          catch (...)
+          {
+              const std::lock_guard<std::mutex> lock(failureMutex);
+              if (! failure) failure = std::current_exception();
+              nextFile = order.size(); // stop the other workers early
+          }
+      };
+
+      std::vector<std::thread> pool;
+      for (unsigned int i = 1; i < numThreads; ++i) pool.emplace_back(worker);
+      worker(); // The calling thread also takes part.
+      for (std::thread & thread : pool) thread.join();
+
+      if (failure) std::rethrow_exception(failure);
+
+      for (const TalkerCounts & counts : fileTalkerCounts) *talkerCounts += counts;
+
+      if (ingestStats != nullptr)
+      {
+          IngestStats totalStats;
+          for (const IngestStats & stats : fileIngestStats) totalStats += stats;
+          totalStats.elapsed = std::chrono::steady_clock::now() - start;
+          *ingestStats += totalStats;
+      }
+
+      return results;
+  }
+
+  GPS::PositionBatch mergeByTime(const std::vector<LogPositions> & logs)
+  {
+      std::vector<std::vector<double>> keys;
+      keys.reserve(logs.size());
+      std::size_t total = 0;
+      for (const LogPositions & log : logs)
+      {
+          keys.push_back(mergeKeysOf(log.positions));
+          total += log.positions.size();
+      }
+
+      std::priority_queue<MergeHead> heads;
+      for (std::size_t file = 0; file < logs.size(); ++file)
+      {
+          if (! keys[file].empty()) heads.push({keys[file][0], file, 0});
+      }
+
+      GPS::PositionBatch merged(true, true);
+      merged.reserve(total);
+      while (! heads.empty())
+      {
+          const MergeHead head = heads.top();
+          heads.pop();
+
+          const GPS::PositionBatch & positions = logs[head.file].positions;
+          merged.push_back(positions[head.index],
+                           positions.timeStamps()[head.index],
+                           positions.hasFixQualities() ? positions.fixQualities()[head.index]
+                                                       : GPS::PositionBatch::unknownFixQuality);
+
+          const std::size_t next = head.index + 1;
+          if (next < keys[head.file].size()) heads.push({keys[head.file][next], head.file, next});
+      }
+      return merged;
+  }
+
+  GPS::PositionBatch mergedPositionsFromLogs(const std::vector<std::string> & filePaths, unsigned int numThreads)
+  {
+      return mergedPositionsFromLogs(filePaths, TalkerSet::gps(), nullptr, numThreads);
+  }
+
+  GPS::PositionBatch mergedPositionsFromLogs(const std::vector<std::string> & filePaths, const TalkerSet & talkers,
+                                             TalkerCounts * talkerCounts, unsigned int numThreads,
+                                             IngestStats * ingestStats)
+  {
+      return mergeByTime(positionsFromLogs(filePaths, talkers, talkerCounts, numThreads, ingestStats));
+  }
+}
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "compressedInput.h"
+#include "mappedFile.h"
+#include "parseNMEA.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      // Files smaller than this are decoded on the calling thread.
+      const std::size_t minParallelFileSize = 256 * 1024;
+
+      // Each thread gets several chunks, so that uneven chunks still balance out.
+      const std::size_t chunksPerThread = 4;
+
+      /* Splits a buffer into roughly equal chunks, each ending just after a '\n' (apart
+       * from the last, which ends at the end of the buffer).
+       */
+      std::vector<std::string_view> splitAtLineBoundaries(std::string_view buffer, std::size_t numChunks)
+      {
+          std::vector<std::string_view> chunks;
+          std::size_t chunkStart = 0;
+          for (std::size_t i = 1; i <= numChunks && chunkStart < buffer.size(); ++i)
+          {
+              std::size_t chunkEnd = buffer.size();
+              if (i < numChunks)
+              {
+                  const std::size_t target = std::max(chunkStart, buffer.size() / numChunks * i);
+                  const std::size_t lineEnd = buffer.find('\n', target);
+                  if (lineEnd != std::string_view::npos) chunkEnd = lineEnd + 1;
+              }
+              chunks.push_back(buffer.substr(chunkStart, chunkEnd - chunkStart));
+              chunkStart = chunkEnd;
+          }
+          return chunks;
+      }
+
+      // Decodes a compressed file as a stream, checking that it decompressed successfully.
+      template <typename Decode>
+      auto decodeCompressed(const std::string & filePath, Decode decode)
+      {
+          GPS::InputFile file(filePath);
+          auto result = decode(file);
+          file.checkDecompression();
+          return result;
+      }
+  }
+
+  std::vector<GPS::Position> positionsFromLog(const std::string & filePath, unsigned int numThreads)
+  {
+      return positionsFromLog(filePath, TalkerSet::gps(), nullptr, numThreads);
+  }
+
+  std::vector<GPS::Position> positionsFromLog(const std::string & filePath, const TalkerSet & talkers,
+                                              TalkerCounts * talkerCounts, unsigned int numThreads,
+                                              IngestStats * ingestStats)
+  {
+      return positionsFromLog(filePath, DecodeQuery(), talkers, talkerCounts, numThreads, ingestStats);
+  }
+
+  std::vector<GPS::Position> positionsFromLog(const std::string & filePath, const DecodeQuery & query,
+                                              const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                                              unsigned int numThreads, IngestStats * ingestStats)
+  {
+      if (GPS::compressionOf(filePath) != GPS::Compression::none)
+      {
+          return decodeCompressed(filePath, [&](std::istream & log)
+          {
+              return positionsFromLog(log, query, talkers, talkerCounts, ingestStats);
+          });
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+
+      const MappedFile file(filePath);
+      const std::string_view contents = file.contents();
+
+      if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+      if (numThreads == 1 || contents.size() < minParallelFileSize)
+      {
+          return positionsFromBuffer(contents, query, talkers, talkerCounts, ingestStats);
+      }
+
+      const std::vector<std::string_view> chunks = splitAtLineBoundaries(contents, numThreads * chunksPerThread);
+      std::vector<std::vector<GPS::Position>> chunkPositions(chunks.size());
+      std::vector<TalkerCounts> chunkTalkerCounts(talkerCounts != nullptr ? chunks.size() : 0);
+      std::vector<IngestStats> chunkIngestStats(ingestStats != nullptr ? chunks.size() : 0);
+
+      // Each worker repeatedly claims the next undecoded chunk.
+      std::atomic<std::size_t> nextChunk{0};
+      std::exception_ptr failure;
+      std::mutex failureMutex;
+      auto worker = [&]()
+      {
+          try
+          {
+              for (std::size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+              {
+                  chunkPositions[i] = positionsFromBuffer(chunks[i], query, talkers,
+                                                          talkerCounts != nullptr ? &chunkTalkerCounts[i] : nullptr,
+                                                          ingestStats != nullptr ? &chunkIngestStats[i] : nullptr);
+              }
+          }
+          catch (...)
+          {
+              const std::lock_guard<std::mutex> lock(failureMutex);
+              if (! failure) failure = std::current_exception();
+              nextChunk = chunks.size(); // stop the other workers early
+          }
+      };
+
+      std::vector<std::thread> pool;
+      for (unsigned int i = 1; i < numThreads; ++i) pool.emplace_back(worker);
+      worker(); // The calling thread also takes part.
+      for (std::thread & thread : pool) thread.join();
+
+      if (failure) std::rethrow_exception(failure);
+
+      for (const TalkerCounts & counts : chunkTalkerCounts) *talkerCounts += counts;
+
+      if (ingestStats != nullptr)
+      {
+          // The chunks' elapsed times overlap, so the wall-clock time is reported instead.
+          IngestStats fileStats;
+          for (const IngestStats & stats : chunkIngestStats) fileStats += stats;
+          fileStats.elapsed = std::chrono::steady_clock::now() - start;
+          *ingestStats += fileStats;
+      }
+
+      std::size_t totalPositions = 0;
+      for (const std::vector<GPS::Position> & positions : chunkPositions) totalPositions += positions.size();
+
+      std::vector<GPS::Position> positions;
+      positions.reserve(totalPositions);
+      for (const std::vector<GPS::Position> & chunk : chunkPositions)
+      {
+          positions.insert(positions.end(), chunk.begin(), chunk.end());
+      }
+      return positions;
+  }
+
+  void positionsFromLogInto(const std::string & filePath, GPS::PositionBatch & batch)
+  {
+      positionsFromLogInto(filePath, batch, TalkerSet::gps());
+  }
+
+  void positionsFromLogInto(const std::string & filePath, GPS::PositionBatch & batch,
+                            const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                            IngestStats * ingestStats)
+  {
+      positionsFromLogInto(filePath, batch, DecodeQuery(), talkers, talkerCounts, ingestStats);
+  }
+
+  void positionsFromLogInto(const std::string & filePath, GPS::PositionBatch & batch, const DecodeQuery & query,
+                            const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                            IngestStats * ingestStats)
+  {
+      // Decoded on the calling thread, as the batch is appended to in order.
+      if (GPS::compressionOf(filePath) != GPS::Compression::none)
+      {
+          decodeCompressed(filePath, [&](std::istream & log)
+          {
+              positionsFromLogInto(log, batch, query, talkers, talkerCounts, ingestStats);
+              return true;
+          });
+          return;
+      }
+
+      const MappedFile file(filePath);
+      positionsFromBufferInto(file.contents(), batch, query, talkers, talkerCounts, ingestStats);
+  }
+
+  std::vector<GPS::TrackPoint> trackPointsFromLog(const std::string & filePath)
+  {
+      return trackPointsFromLog(filePath, TalkerSet::gps());
+  }
+
+  std::vector<GPS::TrackPoint> trackPointsFromLog(const std::string & filePath, const TalkerSet & talkers,
+                                                  TalkerCounts * talkerCounts)
+  {
+      // Decoded on the calling thread, as each point's date may come from an earlier line.
+      if (GPS::compressionOf(filePath) != GPS::Compression::none)
+      {
+          return decodeCompressed(filePath, [&](std::istream & log)
+          {
+              return trackPointsFromLog(log, talkers, talkerCounts);
+          });
+      }
+
+      const MappedFile file(filePath);
+      return trackPointsFromBuffer(file.contents(), talkers, talkerCounts);
+  }
+}
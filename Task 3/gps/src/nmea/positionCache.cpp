@@ -0,0 +1,283 @@
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "positionCache.h"
+#include "parseNMEA.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      const char cacheMagic[8] = { 'N', 'M', 'E', 'A', 'P', 'O', 'S', '\0' };
+      const std::uint32_t cacheVersion = 1;
+      const std::uint32_t byteOrderMark = 0x01020304;
+
+      const std::size_t numColumns = 4; // latitudes, longitudes, elevations, time stamps
+
+      struct CacheHeader
+      {
+          char magic[8];
+          std::uint32_t version;
+          std::uint32_t byteOrder;
+          std::uint64_t count;
+          std::uint64_t sourceSize;
+          std::int64_t sourceModified;
+          std::uint8_t reserved[24]; // zero; pads the columns to a 64-byte boundary
+      };
+
+      static_assert(sizeof(CacheHeader) == 64, "The cache header layout must not depend on the compiler.");
+
+      // Writes a cache with the specified columns; 'timeStamps' may be nullptr.
+      void writeColumns(const std::string & cachePath, std::size_t count,
+                        const double * lats, const double * lons, const double * eles,
+                        const double * timeStamps, const SourceKey & sourceKey)
+      {
+          CacheHeader header = {};
+          std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+          header.version = cacheVersion;
+          header.byteOrder = byteOrderMark;
+          header.count = count;
+          header.sourceSize = sourceKey.size;
+          header.sourceModified = sourceKey.modified;
+
+          const std::string temporaryPath = temporaryPathFor(cachePath);
+          {
+              std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+              if (! file.good()) throw std::invalid_argument("Error writing cache file '" + cachePath + "'.");
+
+              const std::streamsize columnBytes = static_cast<std::streamsize>(count * sizeof(double));
+              file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+              file.write(reinterpret_cast<const char *>(lats), columnBytes);
+              file.write(reinterpret_cast<const char *>(lons), columnBytes);
+              file.write(reinterpret_cast<const char *>(eles), columnBytes);
+              if (timeStamps != nullptr)
+              {
+                  file.write(reinterpret_cast<const char *>(timeStamps), columnBytes);
+              }
+              else
+              {
+                  for (std::size_t i = 0; i < count; ++i)
+                  {
+                      file.write(reinterpret_cast<const char *>(&GPS::PositionBatch::unknownTimeStamp), sizeof(double));
+                  }
+              }
+
+              file.close();
+              if (file.fail())
+              {
+                  std::filesystem::remove(temporaryPath);
+                  throw std::invalid_argument("Error writing cache file '" + cachePath + "'.");
+              }
+          }
+
+          std::error_code error;
+          std::filesystem::rename(temporaryPath, cachePath, error);
+          if (error)
+          {
+              std::filesystem::remove(temporaryPath, error);
+              throw std::invalid_argument("Error writing cache file '" + cachePath + "'.");
+          }
+      }
+
+      // Returns the cache for a log, if there is a valid one for its current version.
+      std::unique_ptr<PositionCache> currentCacheFor(const std::string & filePath, const SourceKey & sourceKey)
+      {
+          const std::string cachePath = cachePathFor(filePath);
+          if (! std::filesystem::exists(cachePath)) return nullptr;
+          try
+          {
+              std::unique_ptr<PositionCache> cache = std::make_unique<PositionCache>(cachePath);
+              if (cache->sourceKey() == sourceKey) return cache;
+          }
+          catch (const std::exception &)
+          {
+              // An unreadable or invalid cache is simply replaced.
+          }
+          return nullptr;
+      }
+
+      // Decodes a log into a batch with time stamps, then tries to cache it.
+      void decodeAndCache(const std::string & filePath, const SourceKey & sourceKey, GPS::PositionBatch & batch)
+      {
+          positionsFromLogInto(filePath, batch);
+          try
+          {
+              writePositionCache(cachePathFor(filePath), batch, sourceKey);
+          }
+          catch (const std::invalid_argument &)
+          {
+              // The cache is only an optimisation, e.g. the directory may be read-only.
+          }
+      }
+  }
+
+  bool SourceKey::operator==(const SourceKey & other) const
+  {
+      return size == other.size && modified == other.modified;
+  }
+
+  bool SourceKey::operator!=(const SourceKey & other) const
+  {
+      return ! (*this == other);
+  }
+
+  SourceKey sourceKeyOf(const std::string & filePath)
+  {
+      std::error_code error;
+      const std::uintmax_t size = std::filesystem::file_size(filePath, error);
+      if (error) throw std::invalid_argument("Error opening source file '" + filePath + "'.");
+      const std::filesystem::file_time_type modified = std::filesystem::last_write_time(filePath, error);
+      if (error) throw std::invalid_argument("Error opening source file '" + filePath + "'.");
+
+      return { static_cast<std::uint64_t>(size), static_cast<std::int64_t>(modified.time_since_epoch().count()) };
+  }
+
+  std::string temporaryPathFor(const std::string & path)
+  {
+      // A random number distinguishes processes, and a counter the calls within one.
+      static const std::uint64_t processNonce = (std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}();
+      static std::atomic<std::uint64_t> counter{0};
+
+      return path + ".tmp." + std::to_string(processNonce) + "." + std::to_string(counter++);
+  }
+
+  void writePositionCache(const std::string & cachePath, const GPS::PositionBatch & batch,
+                          const SourceKey & sourceKey)
+  {
+      writeColumns(cachePath, batch.size(),
+                   batch.latitudes().data(), batch.longitudes().data(), batch.elevations().data(),
+                   batch.hasTimeStamps() ? batch.timeStamps().data() : nullptr,
+                   sourceKey);
+  }
+
+  void writePositionCache(const std::string & cachePath, const std::vector<GPS::Position> & positions,
+                          const SourceKey & sourceKey)
+  {
+      GPS::PositionBatch batch;
+      batch.reserve(positions.size());
+      for (const GPS::Position & position : positions) batch.push_back(position);
+      writePositionCache(cachePath, batch, sourceKey);
+  }
+
+  PositionCache::PositionCache(const std::string & cachePath)
+      : file(cachePath)
+  {
+      const std::string_view contents = file.contents();
+
+      CacheHeader header;
+      if (contents.size() < sizeof(header)) throw std::domain_error("'" + cachePath + "' is not a position cache file.");
+      std::memcpy(&header, contents.data(), sizeof(header));
+
+      if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0)
+      {
+          throw std::domain_error("'" + cachePath + "' is not a position cache file.");
+      }
+      if (header.version != cacheVersion || header.byteOrder != byteOrderMark)
+      {
+          throw std::domain_error("Position cache file '" + cachePath + "' has an incompatible version or byte order.");
+      }
+      if ((contents.size() - sizeof(header)) / (numColumns * sizeof(double)) != header.count ||
+          (contents.size() - sizeof(header)) % (numColumns * sizeof(double)) != 0)
+      {
+          throw std::domain_error("Position cache file '" + cachePath + "' is truncated or corrupt.");
+      }
+
+      count = static_cast<std::size_t>(header.count);
+      key = { header.sourceSize, header.sourceModified };
+
+      // The header is 64 bytes and the file is page-aligned, so the columns are aligned.
+      const double * firstColumn = reinterpret_cast<const double *>(contents.data() + sizeof(header));
+      for (std::size_t i = 0; i < numColumns; ++i) columns[i] = firstColumn + i * count;
+  }
+
+  std::size_t PositionCache::size() const
+  {
+      return count;
+  }
+
+  SourceKey PositionCache::sourceKey() const
+  {
+      return key;
+  }
+
+  const GPS::degrees * PositionCache::latitudes() const
+  {
+      return columns[0];
+  }
+
+  const GPS::degrees * PositionCache::longitudes() const
+  {
+      return columns[1];
+  }
+
+  const GPS::metres * PositionCache::elevations() const
+  {
+      return columns[2];
+  }
+
+  const double * PositionCache::timeStamps() const
+  {
+      return columns[3];
+  }
+
+  GPS::Position PositionCache::operator[](std::size_t index) const
+  {
+      return GPS::Position(latitudes()[index], longitudes()[index], elevations()[index]);
+  }
+
+  std::vector<GPS::Position> PositionCache::positions() const
+  {
+      std::vector<GPS::Position> result;
+      result.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) result.push_back((*this)[i]);
+      return result;
+  }
+
+  void PositionCache::appendTo(GPS::PositionBatch & batch) const
+  {
+      batch.append(count, latitudes(), longitudes(), elevations(), timeStamps());
+  }
+
+  std::string cachePathFor(const std::string & filePath)
+  {
+      return filePath + ".poscache";
+  }
+
+  std::vector<GPS::Position> cachedPositionsFromLog(const std::string & filePath)
+  {
+      const SourceKey sourceKey = sourceKeyOf(filePath);
+      if (const std::unique_ptr<PositionCache> cache = currentCacheFor(filePath, sourceKey))
+      {
+          return cache->positions();
+      }
+
+      GPS::PositionBatch batch(true);
+      decodeAndCache(filePath, sourceKey, batch);
+
+      std::vector<GPS::Position> positions;
+      positions.reserve(batch.size());
+      for (std::size_t i = 0; i < batch.size(); ++i) positions.push_back(batch[i]);
+      return positions;
+  }
+
+  void cachedPositionsFromLogInto(const std::string & filePath, GPS::PositionBatch & batch)
+  {
+      const SourceKey sourceKey = sourceKeyOf(filePath);
+      if (const std::unique_ptr<PositionCache> cache = currentCacheFor(filePath, sourceKey))
+      {
+          cache->appendTo(batch);
+          return;
+      }
+
+      // Decode into a batch with time stamps, so that the cache has them.
+      GPS::PositionBatch decoded(true);
+      decodeAndCache(filePath, sourceKey, decoded);
+      batch.append(decoded.size(), decoded.latitudes().data(), decoded.longitudes().data(),
+                   decoded.elevations().data(), decoded.timeStamps().data());
+  }
+}
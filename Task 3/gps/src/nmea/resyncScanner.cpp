@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "resyncScanner.h"
+#include "byteScan.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      // The '*' is followed by two hexadecimal digits.
+      const std::size_t checksumLength = 2;
+  }
+
+  ResyncScanner::ResyncScanner(std::string_view buffer, const TalkerSet & talkers)
+      : buffer(buffer), talkers(talkers)
+  {}
+
+  bool ResyncScanner::next(SentenceView & sentence)
+  {
+      while (position < buffer.size())
+      {
+          // Hunt for the next start marker.
+          const void * start = std::memchr(buffer.data() + position, ByteScan::sentenceStart, buffer.size() - position);
+          if (start == nullptr)
+          {
+              position = buffer.size();
+              break;
+          }
+          position = static_cast<const char *>(start) - buffer.data();
+
+          const std::size_t length = candidateLength();
+          if (length == 0) continue;
+
+          ++stats.linesRead;
+          const std::string_view candidate = buffer.substr(position, length);
+          switch (scanSentence(candidate, sentence, talkers))
+          {
+              case SentenceStatus::ok:
+                  position += length;
+                  stats.bytesRead = position;
+                  return true;
+              case SentenceStatus::malformed:
+                  ++stats.malformed;
+                  break;
+              case SentenceStatus::badChecksum:
+                  ++stats.badChecksum;
+                  break;
+              case SentenceStatus::unsupportedFormat:
+                  ++stats.unsupportedFormat;
+                  position += length;
+                  continue;
+          }
+
+          // Resume just after the '*', in case the checksum characters are another '$'.
+          position += length - checksumLength;
+      }
+      stats.bytesRead = buffer.size();
+      return false;
+  }
+
+  std::size_t ResyncScanner::candidateLength()
+  {
+      const std::size_t end = std::min(buffer.size(), position + maxSentenceLength);
+
+      // Skip from delimiter to delimiter, starting after the '$'.
+      std::size_t i = position + 1;
+      while (true)
+      {
+          i += ByteScan::findDelimiter(buffer.data() + i, end - i);
+          if (i == end || buffer[i] == ByteScan::sentenceStart || buffer[i] == ByteScan::lineEnd)
+          {
+              // Abandoned: the next candidate cannot start before here.
+              position = i;
+              return 0;
+          }
+          if (buffer[i] == ByteScan::checksumDelimiter) break;
+          ++i; // a ','
+      }
+
+      const std::size_t length = i + 1 + checksumLength - position;
+      if (position + length > buffer.size())
+      {
+          position = buffer.size(); // truncated at the end of the buffer
+          return 0;
+      }
+      return length;
+  }
+
+  std::size_t ResyncScanner::offset() const
+  {
+      return position;
+  }
+
+  const IngestStats & ResyncScanner::ingestStats() const
+  {
+      return stats;
+  }
+
+  std::vector<GPS::Position> positionsFromNoisyBuffer(std::string_view buffer)
+  {
+      return positionsFromNoisyBuffer(buffer, TalkerSet::gps());
+  }
+
+  std::vector<GPS::Position> positionsFromNoisyBuffer(std::string_view buffer, const TalkerSet & talkers,
+                                                      IngestStats * ingestStats)
+  {
+      const auto start = std::chrono::steady_clock::now();
+
+      std::vector<GPS::Position> positions;
+      IngestStats interpreted;
+      ResyncScanner scanner(buffer, talkers);
+      SentenceView sentence;
+      while (scanner.next(sentence))
+      {
+          const InterpretResult result = tryInterpretSentenceData(sentence);
+          if (result)
+          {
+              interpreted.addAccepted(sentence.format());
+              positions.push_back(*result);
+          }
+          else
+          {
+              ++interpreted.invalidFields;
+          }
+      }
+
+      if (ingestStats != nullptr)
+      {
+          interpreted += scanner.ingestStats();
+          interpreted.elapsed = std::chrono::steady_clock::now() - start;
+          *ingestStats += interpreted;
+      }
+      return positions;
+  }
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "streamDecoder.h"
+
+namespace NMEA
+{
+  StreamDecoder::StreamDecoder(PositionHandler handler, const TalkerSet & talkers)
+      : handlePosition(std::move(handler)), talkers(talkers)
+  {
+      partialLine.reserve(maxLineLength);
+  }
+
+  StreamDecoder StreamDecoder::fusingEpochs(EpochFusion::FixHandler handler, const TalkerSet & talkers)
+  {
+      return StreamDecoder(FusingEpochs{}, std::move(handler), talkers);
+  }
+
+  StreamDecoder::StreamDecoder(FusingEpochs, EpochFusion::FixHandler handler, const TalkerSet & talkers)
+      : fusion(std::in_place, std::move(handler)), talkers(talkers)
+  {
+      partialLine.reserve(maxLineLength);
+  }
+
+  void StreamDecoder::feed(const char * data, std::size_t length)
+  {
+      const auto start = std::chrono::steady_clock::now();
+      stats.bytesRead += length;
+      feedLines(data, length);
+      stats.elapsed += std::chrono::steady_clock::now() - start;
+  }
+
+  void StreamDecoder::feedLines(const char * data, std::size_t length)
+  {
+      while (length > 0)
+      {
+          const char * lineEnd = static_cast<const char *>(std::memchr(data, '\n', length));
+          const std::size_t available = (lineEnd == nullptr) ? length : static_cast<std::size_t>(lineEnd - data);
+
+          if (! discardingLine)
+          {
+              if (partialLine.size() + available > maxLineLength)
+              {
+                  partialLine.clear();
+                  discardingLine = true;
+              }
+              else if (lineEnd != nullptr && partialLine.empty())
+              {
+                  // The whole line is in this chunk, so decode it in place.
+                  decodeLine(std::string_view(data, available));
+              }
+              else
+              {
+                  partialLine.append(data, available);
+                  if (lineEnd != nullptr)
+                  {
+                      decodeLine(partialLine);
+                      partialLine.clear();
+                  }
+              }
+          }
+
+          if (lineEnd == nullptr) return;
+
+          if (discardingLine) countDiscardedLine();
+          discardingLine = false;
+          data += available + 1;
+          length -= available + 1;
+      }
+  }
+
+  void StreamDecoder::finish()
+  {
+      if (! discardingLine && ! partialLine.empty()) decodeLine(partialLine);
+      if (discardingLine) countDiscardedLine();
+      partialLine.clear();
+      discardingLine = false;
+
+      if (fusion) fusion->finish();
+  }
+
+  void StreamDecoder::decodeLine(std::string_view line)
+  {
+      const std::optional<GPS::Position> position = decodeLogLine(line, sentence, talkers, stats);
+      if (! position) return;
+
+      const std::string_view talker = sentence.talker();
+      decodedCounts.add(talker[0], talker[1]);
+
+      if (fusion)
+      {
+          fusion->add(sentence, *position);
+      }
+      else
+      {
+          handlePosition(*position);
+      }
+  }
+
+  void StreamDecoder::countDiscardedLine()
+  {
+      ++stats.linesRead;
+      ++stats.malformed;
+  }
+
+  const TalkerCounts & StreamDecoder::talkerCounts() const
+  {
+      return decodedCounts;
+  }
+
+  const IngestStats & StreamDecoder::ingestStats() const
+  {
+      return stats;
+  }
+}
@@ -0,0 +1,59 @@
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "talkers.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      std::size_t checkedTalkerIndex(std::string_view talker)
+      {
+          const std::size_t index = (talker.size() == 2) ? talkerIndex(talker[0], talker[1]) : numTalkerIDs;
+          if (index == numTalkerIDs)
+          {
+              throw std::invalid_argument("'" + std::string(talker) + "' is not a valid talker ID.  Talker IDs must be two upper-case letters.");
+          }
+          return index;
+      }
+  }
+
+  TalkerSet::TalkerSet(std::initializer_list<std::string_view> talkers)
+  {
+      for (std::string_view talker : talkers) members.set(checkedTalkerIndex(talker));
+  }
+
+  const TalkerSet & TalkerSet::gps()
+  {
+      static const TalkerSet talkers = {"GP"};
+      return talkers;
+  }
+
+  const TalkerSet & TalkerSet::allConstellations()
+  {
+      static const TalkerSet talkers = {"GP", "GL", "GA", "BD", "GB", "GN"};
+      return talkers;
+  }
+
+  bool TalkerSet::contains(std::string_view talker) const
+  {
+      return talker.size() == 2 && contains(talker[0], talker[1]);
+  }
+
+  std::uint64_t TalkerCounts::operator[](std::string_view talker) const
+  {
+      return counts[checkedTalkerIndex(talker)];
+  }
+
+  std::uint64_t TalkerCounts::total() const
+  {
+      return std::accumulate(counts.begin(), counts.end(), std::uint64_t(0));
+  }
+
+  TalkerCounts & TalkerCounts::operator+=(const TalkerCounts & other)
+  {
+      for (std::size_t i = 0; i < numTalkerIDs; ++i) counts[i] += other.counts[i];
+      return *this;
+  }
+}
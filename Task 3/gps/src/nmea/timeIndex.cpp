@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "timeIndex.h"
+#include "compressedInput.h"
+#include "mappedFile.h"
+#include "parseNMEA.h"
+
+namespace NMEA
+{
+  namespace
+  {
+      const char indexMagic[8] = { 'N', 'M', 'E', 'A', 'T', 'I', 'X', '\0' };
+      const std::uint32_t indexVersion = 1;
+      const std::uint32_t byteOrderMark = 0x01020304;
+
+      struct IndexHeader
+      {
+          char magic[8];
+          std::uint32_t version;
+          std::uint32_t byteOrder;
+          std::uint64_t count;
+          std::uint64_t epochsPerEntry;
+          std::uint64_t sourceSize;
+          std::int64_t sourceModified;
+          std::uint8_t reserved[16]; // zero
+      };
+
+      static_assert(sizeof(IndexHeader) == 64, "The index header layout must not depend on the compiler.");
+
+      const double secondsPerDay = 24 * 60 * 60;
+
+      /* Converts times of day into times since midnight at the start of the first day,
+       * assuming that a time more than 12 hours earlier than the last one is on the next day.
+       */
+      class DayRollover
+      {
+        public:
+          DayRollover() = default;
+
+          // Continues from a time (in the same scale as the results).
+          explicit DayRollover(double latest)
+              : latest(latest), dayStart(std::floor(latest / secondsPerDay) * secondsPerDay)
+          {}
+
+          // Pre-condition: the time of day is not NaN.
+          double operator()(double timeOfDay)
+          {
+              double time = dayStart + timeOfDay;
+              if (time < latest - secondsPerDay / 2)
+              {
+                  dayStart += secondsPerDay;
+                  time += secondsPerDay;
+              }
+              latest = time;
+              return time;
+          }
+
+        private:
+          double latest = -std::numeric_limits<double>::infinity();
+          double dayStart = 0;
+      };
+
+      // Appends the Positions of a decoded slice that are timed within [from, to].
+      void appendBetween(const GPS::PositionBatch & slice, DayRollover rollover, double from, double to,
+                         GPS::PositionBatch & result)
+      {
+          for (std::size_t i = 0; i < slice.size(); ++i)
+          {
+              const double timeOfDay = slice.timeStamps()[i];
+              if (std::isnan(timeOfDay)) continue;
+
+              const double time = rollover(timeOfDay);
+              if (time > to) break;
+              if (time >= from) result.push_back(slice[i], timeOfDay, slice.fixQualities()[i]);
+          }
+      }
+
+      // Returns the index for a log, if there is a valid one for its current version.
+      bool readCurrentIndex(const std::string & filePath, const SourceKey & sourceKey, TimeIndex & index)
+      {
+          const std::string indexPath = timeIndexPathFor(filePath);
+          if (! std::filesystem::exists(indexPath)) return false;
+          try
+          {
+              index = readTimeIndex(indexPath);
+              return index.sourceKey == sourceKey;
+          }
+          catch (const std::exception &)
+          {
+              // An unreadable or invalid index is simply replaced.
+              return false;
+          }
+      }
+  }
+
+  std::pair<std::uint64_t,std::uint64_t> TimeIndex::byteRange(double from, double to, std::uint64_t logSize) const
+  {
+      // Start at the last indexed epoch no later than 'from'...
+      const auto first = std::upper_bound(times.begin(), times.end(), from);
+      const std::uint64_t start = (first == times.begin()) ? 0 : offsets[first - times.begin() - 1];
+
+      // ...and end at the first indexed epoch later than 'to'.
+      const auto last = std::upper_bound(times.begin(), times.end(), to);
+      const std::uint64_t end = (last == times.end()) ? logSize : offsets[last - times.begin()];
+
+      return { start, std::max(start, end) };
+  }
+
+  TimeIndex buildTimeIndex(std::string_view log, std::size_t epochsPerEntry, const TalkerSet & talkers)
+  {
+      if (epochsPerEntry == 0) throw std::invalid_argument("An index needs at least one epoch per entry.");
+
+      TimeIndex index;
+      index.epochsPerEntry = epochsPerEntry;
+
+      SentenceView sentence;
+      DayRollover rollover;
+      double epochTime = std::numeric_limits<double>::quiet_NaN();
+      std::size_t epochs = 0;
+
+      for (std::size_t lineStart = 0; lineStart < log.size(); )
+      {
+          std::size_t lineEnd = log.find('\n', lineStart);
+          if (lineEnd == std::string_view::npos) lineEnd = log.size();
+
+          std::string_view line = log.substr(lineStart, lineEnd - lineStart);
+          if (! line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+          if (scanSentence(line, sentence, talkers) == SentenceStatus::ok)
+          {
+              const double timeOfDay = NMEA::timeOfDay(sentence);
+              if (! std::isnan(timeOfDay))
+              {
+                  const double time = rollover(timeOfDay);
+                  if (time != epochTime)
+                  {
+                      if (epochs++ % epochsPerEntry == 0)
+                      {
+                          index.times.push_back(time);
+                          index.offsets.push_back(lineStart);
+                      }
+                      epochTime = time;
+                  }
+              }
+          }
+          lineStart = lineEnd + 1;
+      }
+      return index;
+  }
+
+  void writeTimeIndex(const std::string & indexPath, const TimeIndex & index)
+  {
+      IndexHeader header = {};
+      std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+      header.version = indexVersion;
+      header.byteOrder = byteOrderMark;
+      header.count = index.times.size();
+      header.epochsPerEntry = index.epochsPerEntry;
+      header.sourceSize = index.sourceKey.size;
+      header.sourceModified = index.sourceKey.modified;
+
+      const std::string temporaryPath = temporaryPathFor(indexPath);
+      {
+          std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+          if (! file.good()) throw std::invalid_argument("Error writing index file '" + indexPath + "'.");
+
+          file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+          file.write(reinterpret_cast<const char *>(index.times.data()),
+                     static_cast<std::streamsize>(index.times.size() * sizeof(double)));
+          file.write(reinterpret_cast<const char *>(index.offsets.data()),
+                     static_cast<std::streamsize>(index.offsets.size() * sizeof(std::uint64_t)));
+
+          file.close();
+          if (file.fail())
+          {
+              std::filesystem::remove(temporaryPath);
+              throw std::invalid_argument("Error writing index file '" + indexPath + "'.");
+          }
+      }
+
+      std::error_code error;
+      std::filesystem::rename(temporaryPath, indexPath, error);
+      if (error)
+      {
+          std::filesystem::remove(temporaryPath, error);
+          throw std::invalid_argument("Error writing index file '" + indexPath + "'.");
+      }
+  }
+
+  TimeIndex readTimeIndex(const std::string & indexPath)
+  {
+      std::ifstream file(indexPath, std::ios::binary);
+      if (! file.good()) throw std::invalid_argument("Error opening source file '" + indexPath + "'.");
+
+      IndexHeader header;
+      if (! file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+          std::memcmp(header.magic, indexMagic, sizeof(indexMagic)) != 0)
+      {
+          throw std::domain_error("'" + indexPath + "' is not a time index file.");
+      }
+      if (header.version != indexVersion || header.byteOrder != byteOrderMark)
+      {
+          throw std::domain_error("Time index file '" + indexPath + "' has an incompatible version or byte order.");
+      }
+
+      const std::uintmax_t entryBytes = sizeof(double) + sizeof(std::uint64_t);
+      // Checked by division, so that a corrupt count cannot overflow the expected size.
+      const std::uintmax_t fileSize = std::filesystem::file_size(indexPath);
+      if ((fileSize - sizeof(header)) / entryBytes != header.count || (fileSize - sizeof(header)) % entryBytes != 0)
+      {
+          throw std::domain_error("Time index file '" + indexPath + "' is truncated or corrupt.");
+      }
+
+      TimeIndex index;
+      index.epochsPerEntry = static_cast<std::size_t>(header.epochsPerEntry);
+      index.sourceKey = { header.sourceSize, header.sourceModified };
+      index.times.resize(static_cast<std::size_t>(header.count));
+      index.offsets.resize(static_cast<std::size_t>(header.count));
+      file.read(reinterpret_cast<char *>(index.times.data()),
+                static_cast<std::streamsize>(index.times.size() * sizeof(double)));
+      file.read(reinterpret_cast<char *>(index.offsets.data()),
+                static_cast<std::streamsize>(index.offsets.size() * sizeof(std::uint64_t)));
+      if (! file) throw std::domain_error("Time index file '" + indexPath + "' is truncated or corrupt.");
+
+      return index;
+  }
+
+  std::string timeIndexPathFor(const std::string & filePath)
+  {
+      return filePath + ".timeidx";
+  }
+
+  GPS::PositionBatch positionsBetween(const std::string & filePath, double from, double to)
+  {
+      GPS::PositionBatch result(true, true);
+
+      if (GPS::compressionOf(filePath) != GPS::Compression::none)
+      {
+          GPS::PositionBatch all(true, true);
+          positionsFromLogInto(filePath, all);
+          appendBetween(all, DayRollover(), from, to, result);
+          return result;
+      }
+
+      const SourceKey sourceKey = sourceKeyOf(filePath);
+      const MappedFile file(filePath);
+      const std::string_view log = file.contents();
+
+      TimeIndex index;
+      if (! readCurrentIndex(filePath, sourceKey, index))
+      {
+          index = buildTimeIndex(log);
+          index.sourceKey = sourceKey;
+          try
+          {
+              writeTimeIndex(timeIndexPathFor(filePath), index);
+          }
+          catch (const std::invalid_argument &)
+          {
+              // The index is only an optimisation, e.g. the directory may be read-only.
+          }
+      }
+
+      const auto [start, end] = index.byteRange(from, to, log.size());
+
+      // The slice starts at an indexed epoch, so its times continue from that epoch's time.
+      const auto entry = std::find(index.offsets.begin(), index.offsets.end(), start);
+      const DayRollover rollover = (entry == index.offsets.end()) ? DayRollover()
+                                                                  : DayRollover(index.times[entry - index.offsets.begin()]);
+
+      GPS::PositionBatch slice(true, true);
+      positionsFromBufferInto(log.substr(start, end - start), slice);
+      appendBetween(slice, rollover, from, to, result);
+      return result;
+  }
+}
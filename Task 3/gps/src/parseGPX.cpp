@@ -4,6 +4,7 @@
 
 #include "xml/parser.h"
 
+#include "compressedInput.h"
 #include "parseGPX.h"
 
 namespace GPX
@@ -21,13 +22,14 @@ namespace GPX
       Element ele = SelfClosingElement("",{}), temp = ele, temp2 = ele; // Work-around because there's no public constructor in Element.
       Position startPos(0,0), prevPos = startPos, nextPos = startPos; // Same thing but for Position.
       if (isFileName) {
-          ifstream fs(source);
+          InputFile fs(source); // Transparently decompresses gzip/zstd files.
           if (! fs.good()) throw invalid_argument("Error opening source file '" + source + "'.");
           oss << "Source file '" << source << "' opened okay." << endl;
           while (fs.good()) {
               getline(fs, name); // Using name as temporary variable as we don't need it until later
               oss2 << name << endl;
           }
+          fs.checkDecompression();
           source = oss2.str();
       }
       ele = Parser(source).parseRootElement();
@@ -137,13 +139,14 @@ namespace GPX
       Element ele = SelfClosingElement("",{}), temp = ele, temp2 = ele, ele2 = ele; // Work-around because there's no public constructor in Element.
       Position startPos(0,0), prevPos = startPos, nextPos = startPos; // Same thing but for Position.
       if (isFileName) {
-          ifstream fs(source);
+          InputFile fs(source); // Transparently decompresses gzip/zstd files.
           if (! fs.good()) throw invalid_argument("Error opening source file '" + source + "'.");
           oss << "Source file '" << source << "' opened okay." << endl;
           while (fs.good()) {
               getline(fs, name); // Using name as temporary variable as we don't need it until later
               oss2 << name << endl;
           }
+          fs.checkDecompression();
           source = oss2.str();
       }
       ele = Parser(source).parseRootElement();
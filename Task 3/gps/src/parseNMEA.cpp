@@ -1,42 +1,1067 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
 #include "earth.h"
+#include "geometry.h"
+#include "byteScan.h"
 #include "parseNMEA.h"
+#include "epochFusion.h"
+#include "packedFormat.h"
 
 namespace NMEA
 {
-  bool isSupportedSentenceFormat(std::string format)
+  namespace
   {
-      // Stub definition, needs implementing
-      return false;
+      const std::size_t talkerPos = 1;
+      const std::size_t talkerLength = 2;
+      const std::size_t formatPos = talkerPos + talkerLength;
+      const std::size_t formatLength = 3;
+      const std::size_t firstDelimiterPos = formatPos + formatLength;
+      const std::size_t checksumLength = 2;
+
+      // The shortest well-formed sentence, e.g. "$GPXXX,*hh".
+      const std::size_t minSentenceLength = firstDelimiterPos + 2 + checksumLength;
+
+      // Returns the value of a hexadecimal digit, or -1 if the character is not one.
+      int hexDigitValue(char c)
+      {
+          if (c >= '0' && c <= '9') return c - '0';
+          if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+          if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+          return -1;
+      }
+
+      // A bearing field must contain exactly one character; returns '\0' if it does not.
+      char bearingOf(std::string_view field)
+      {
+          return (field.size() == 1) ? field.front() : '\0';
+      }
+
+      // Uniform access to the data fields of either a SentenceData or a SentenceView.
+      class SentenceFields
+      {
+        public:
+          explicit SentenceFields(const SentenceData & data) : data(&data) {}
+          explicit SentenceFields(const SentenceView & view) : view(&view) {}
+
+          std::size_t size() const
+          {
+              return view ? view->numFields() : data->dataFields.size();
+          }
+
+          // Pre-condition: the index is less than size().
+          std::string_view operator[](std::size_t index) const
+          {
+              return view ? view->field(index) : std::string_view(data->dataFields[index]);
+          }
+
+        private:
+          const SentenceData * data = nullptr;
+          const SentenceView * view = nullptr;
+      };
+
+      // Indicates that a sentence format has no such field.
+      const std::size_t noField = std::numeric_limits<std::size_t>::max();
+
+      // Accepts every sentence and decodes every output.
+      const DecodeQuery unrestricted;
+
+      /* Decodes a DDM angle field and its bearing field, as Position::tryFromDDM() does.
+       * Returns false if either is invalid.
+       */
+      bool tryAngle(std::string_view ddmField, std::string_view bearingField,
+                    char positiveBearing, char negativeBearing, GPS::degrees maxMagnitude,
+                    GPS::degrees & angle)
+      {
+          if (! GPS::tryParseDDM(ddmField, angle) || angle < 0) return false;
+
+          const char bearing = bearingOf(bearingField);
+          if (bearing == negativeBearing)
+          {
+              angle = -angle;
+          }
+          else if (bearing != positiveBearing)
+          {
+              return false;
+          }
+          return std::abs(angle) <= maxMagnitude;
+      }
+
+      /* Constructs a Position from the DDM latitude and longitude fields (and optionally
+       * the elevation field) at the specified indexes.
+       * Both coordinates are decoded and validated before the bounding box of the query is
+       * applied, so that an invalid sentence is always reported as such.  The elevation is
+       * only decoded if the query asks for it.
+       */
+      InterpretResult positionFromFields(const SentenceFields & fields, const DecodeQuery & query,
+                                         std::size_t latitude, std::size_t northing,
+                                         std::size_t longitude, std::size_t easting,
+                                         std::size_t elevation = noField)
+      {
+          const std::size_t lastIndex = std::max({latitude, northing, longitude, easting,
+                                                  elevation == noField ? 0 : elevation});
+          if (lastIndex >= fields.size()) return InterpretError::missingFields;
+
+          GPS::degrees lat, lon;
+          if (! tryAngle(fields[latitude], fields[northing], 'N', 'S', GPS::poleLatitude, lat) ||
+              ! tryAngle(fields[longitude], fields[easting], 'E', 'W', GPS::antiMeridianLongitude, lon))
+          {
+              return InterpretError::invalidFields;
+          }
+          if (! query.acceptsLatitude(lat) || ! query.acceptsLongitude(lon)) return InterpretError::filteredOut;
+
+          GPS::metres ele = 0;
+          if (elevation != noField && query.elevations && ! GPS::tryParseDecimal(fields[elevation], ele))
+          {
+              return InterpretError::invalidFields;
+          }
+          return GPS::Position(lat, lon, ele);
+      }
+
+      // The decoders for each supported sentence format.
+
+      InterpretResult decodeGLL(const SentenceFields & fields, const DecodeQuery & query)
+      {
+          return positionFromFields(fields, query, 0, 1, 2, 3);
+      }
+
+      InterpretResult decodeGGA(const SentenceFields & fields, const DecodeQuery & query)
+      {
+          return positionFromFields(fields, query, 1, 2, 3, 4, 8);
+      }
+
+      InterpretResult decodeRMC(const SentenceFields & fields, const DecodeQuery & query)
+      {
+          return positionFromFields(fields, query, 2, 3, 4, 5);
+      }
+
+      using SentenceDecoder = InterpretResult (*)(const SentenceFields &, const DecodeQuery &);
+
+      struct FormatDecoder
+      {
+          std::string_view format;
+          SentenceDecoder decode;
+          std::size_t timeField;       // the UTC time of day
+          std::size_t fixQualityField; // the fix quality (GGA) or status (GLL, RMC)
+          std::size_t dateField;       // the UTC date
+          std::size_t speedField;      // the speed over ground, in knots
+          std::size_t courseField;     // the course over ground, in degrees true
+      };
+
+      /* The supported sentence formats.
+       * To support a new format, add its decoder here; the dispatch table below is
+       * generated from this at compile-time.
+       */
+      constexpr FormatDecoder formatDecoders[] = {
+          { "GLL", decodeGLL, 4, 5, noField, noField, noField },
+          { "GGA", decodeGGA, 0, 5, noField, noField, noField },
+          { "RMC", decodeRMC, 0, 1, 8,       6,       7       }
+      };
+
+      /* A perfect hash from the three-character format codes in 'formatDecoders' to the
+       * slots of a small table.  The codes are packed into an integer, multiplied, and
+       * the top bits used as the slot; the multiplier is found at compile-time so that
+       * no two supported codes share a slot.  Any other code either lands in an empty
+       * slot or fails the comparison with the slot's code, so a lookup is always one
+       * multiplication and one comparison.
+       */
+      constexpr unsigned int dispatchTableBits = 4;
+      constexpr std::size_t dispatchTableSize = std::size_t(1) << dispatchTableBits;
+
+      static_assert(std::size(formatDecoders) <= dispatchTableSize, "Too many formats for the dispatch table.");
+
+      constexpr std::size_t dispatchSlot(std::uint32_t packedFormat, std::uint32_t multiplier)
+      {
+          return static_cast<std::uint32_t>(packedFormat * multiplier) >> (32 - dispatchTableBits);
+      }
+
+      constexpr bool isPerfectMultiplier(std::uint32_t multiplier)
+      {
+          for (std::size_t i = 0; i < std::size(formatDecoders); ++i)
+          {
+              for (std::size_t j = i + 1; j < std::size(formatDecoders); ++j)
+              {
+                  if (dispatchSlot(packFormat(formatDecoders[i].format), multiplier) ==
+                      dispatchSlot(packFormat(formatDecoders[j].format), multiplier)) return false;
+              }
+          }
+          return true;
+      }
+
+      constexpr std::uint32_t findPerfectMultiplier()
+      {
+          // Odd multipliers near the golden ratio scatter the bits well.
+          for (std::uint32_t multiplier = 0x9E3779B1u; ; multiplier += 2)
+          {
+              if (isPerfectMultiplier(multiplier)) return multiplier;
+          }
+      }
+
+      constexpr std::uint32_t dispatchMultiplier = findPerfectMultiplier();
+
+      struct DispatchSlot
+      {
+          std::uint32_t packedFormat = 0; // zero for an empty slot, as no format packs to zero
+          const FormatDecoder * decoder = nullptr;
+      };
+
+      constexpr std::array<DispatchSlot,dispatchTableSize> buildDispatchTable()
+      {
+          std::array<DispatchSlot,dispatchTableSize> table = {};
+          for (const FormatDecoder & decoder : formatDecoders)
+          {
+              const std::uint32_t packedFormat = packFormat(decoder.format);
+              DispatchSlot & slot = table[dispatchSlot(packedFormat, dispatchMultiplier)];
+              slot.packedFormat = packedFormat;
+              slot.decoder = &decoder;
+          }
+          return table;
+      }
+
+      constexpr std::array<DispatchSlot,dispatchTableSize> dispatchTable = buildDispatchTable();
+
+      // Returns the decoder for a sentence format, or nullptr if the format is unsupported.
+      const FormatDecoder * decoderFor(std::string_view format)
+      {
+          if (format.size() != formatLength) return nullptr;
+
+          const std::uint32_t packedFormat = packFormat(format);
+          const DispatchSlot & slot = dispatchTable[dispatchSlot(packedFormat, dispatchMultiplier)];
+          return (slot.packedFormat == packedFormat) ? slot.decoder : nullptr;
+      }
+
+      InterpretResult interpretFields(std::string_view format, const SentenceFields & fields,
+                                      const DecodeQuery & query = unrestricted)
+      {
+          const FormatDecoder * decoder = decoderFor(format);
+          if (decoder == nullptr) return InterpretError::unsupportedFormat;
+          return decoder->decode(fields, query);
+      }
+
+      GPS::Position valueOrThrow(const InterpretResult & result)
+      {
+          if (result) return *result;
+
+          switch (result.error())
+          {
+              case InterpretError::unsupportedFormat:
+                  throw std::invalid_argument("Unsupported sentence format.");
+              case InterpretError::missingFields:
+                  throw std::invalid_argument("Missing data fields.");
+              case InterpretError::invalidFields:
+              case InterpretError::filteredOut: // not possible without a DecodeQuery
+              default:
+                  throw std::invalid_argument("Invalid data fields.");
+          }
+      }
+
+      /* Calls 'visit(start,length)' for each data field of a well-formed sentence, where
+       * 'start' and 'length' locate the field contents within the sentence.
+       */
+      template <typename FieldVisitor>
+      void forEachField(std::string_view sentence, FieldVisitor visit)
+      {
+          const std::size_t checksumPos = sentence.size() - checksumLength - 1;
+          std::size_t fieldStart = firstDelimiterPos + 1;
+          for (std::size_t i = fieldStart; i <= checksumPos; ++i)
+          {
+              if (sentence[i] == ',' || i == checksumPos)
+              {
+                  visit(fieldStart, i - fieldStart);
+                  fieldStart = i + 1;
+              }
+          }
+      }
+  }
+
+  bool isSupportedSentenceFormat(std::string_view format)
+  {
+      return decoderFor(format) != nullptr;
+  }
+
+  bool isWellFormedSentence(std::string_view candidateSentence)
+  {
+      return isWellFormedSentence(candidateSentence, TalkerSet::gps());
+  }
+
+  bool isWellFormedSentence(std::string_view candidateSentence, const TalkerSet & talkers)
+  {
+      if (candidateSentence.size() < minSentenceLength) return false;
+
+      if (candidateSentence[0] != '$') return false;
+
+      if (! talkers.contains(candidateSentence[talkerPos], candidateSentence[talkerPos + 1])) return false;
+
+      for (std::size_t i = formatPos; i < firstDelimiterPos; ++i)
+      {
+          if (candidateSentence[i] < 'A' || candidateSentence[i] > 'Z') return false;
+      }
+
+      // There must be at least one (possibly empty) data field.
+      if (candidateSentence[firstDelimiterPos] != ',') return false;
+
+      const std::size_t checksumPos = candidateSentence.size() - checksumLength - 1;
+      if (candidateSentence[checksumPos] != '*') return false;
+
+      for (std::size_t i = firstDelimiterPos + 1; i < checksumPos; ++i)
+      {
+          if (candidateSentence[i] == '$' || candidateSentence[i] == '*') return false;
+      }
+
+      return hexDigitValue(candidateSentence[checksumPos + 1]) >= 0
+          && hexDigitValue(candidateSentence[checksumPos + 2]) >= 0;
+  }
+
+  bool hasCorrectChecksum(std::string_view sentence)
+  {
+      assert(sentence.size() >= minSentenceLength);
+
+      const std::size_t checksumPos = sentence.size() - checksumLength - 1;
+
+      // XOR reduction of everything between the '$' and the '*' (exclusive).
+      const unsigned char totalXOR = ByteScan::xorReduce(sentence.data() + 1, checksumPos - 1);
+
+      const int checksum = hexDigitValue(sentence[checksumPos + 1]) * 16
+                         + hexDigitValue(sentence[checksumPos + 2]);
+      return totalXOR == checksum;
+  }
+
+  SentenceData parseSentenceData(std::string_view sentence)
+  {
+      assert(sentence.size() >= minSentenceLength);
+
+      SentenceData parsedSentence;
+      parsedSentence.format = std::string(sentence.substr(formatPos, formatLength));
+      forEachField(sentence, [&](std::size_t start, std::size_t length)
+      {
+          parsedSentence.dataFields.emplace_back(sentence.substr(start, length));
+      });
+      return parsedSentence;
   }
 
-  bool isWellFormedSentence(std::string candidateSentence)
+  std::string_view SentenceView::talker() const
   {
-      // Stub definition, needs implementing
-      return true;
+      return sentence.substr(talkerPos, talkerLength);
   }
 
-  bool hasCorrectChecksum(std::string sentence)
+  std::string_view SentenceView::format() const
   {
-      // Stub definition, needs implementing
-      return false;
+      return sentence.substr(formatPos, formatLength);
   }
 
-  SentenceData parseSentenceData(std::string sentence)
+  std::size_t SentenceView::numFields() const
   {
-      // Stub definition, needs implementing
-      return {"",{}};
+      return fieldCount;
+  }
+
+  std::string_view SentenceView::field(std::size_t index) const
+  {
+      if (index >= fieldCount) throw std::out_of_range("Data field index out-of-range.");
+
+      const std::size_t start = delimiter(index) + 1;
+      return sentence.substr(start, delimiter(index + 1) - start);
+  }
+
+  std::string_view SentenceView::fieldView(std::size_t index) const
+  {
+      return field(index);
+  }
+
+  template <>
+  double SentenceView::field<double>(std::size_t index) const
+  {
+      return GPS::parseDecimal(field(index));
+  }
+
+  template <>
+  std::string_view SentenceView::field<std::string_view>(std::size_t index) const
+  {
+      return field(index);
+  }
+
+  bool SentenceView::tryField(std::size_t index, double & value) const
+  {
+      return index < fieldCount && GPS::tryParseDecimal(field(index), value);
+  }
+
+  std::uint16_t SentenceView::delimiter(std::size_t index) const
+  {
+      return (index <= inlineFields) ? inlineDelimiters[index] : spilledDelimiters[index - inlineFields - 1];
+  }
+
+  void SentenceView::startFields(std::uint16_t firstDelimiter)
+  {
+      fieldCount = 0;
+      inlineDelimiters[0] = firstDelimiter;
+      spilledDelimiters.clear();
+  }
+
+  void SentenceView::endField(std::uint16_t delimiter)
+  {
+      if (++fieldCount <= inlineFields)
+      {
+          inlineDelimiters[fieldCount] = delimiter;
+      }
+      else
+      {
+          spilledDelimiters.push_back(delimiter);
+      }
+  }
+
+  SentenceView parseSentenceView(std::string_view sentence)
+  {
+      assert(sentence.size() >= minSentenceLength);
+
+      if (sentence.size() > UINT16_MAX) throw std::length_error("Sentence too long for a SentenceView.");
+
+      SentenceView view;
+      view.sentence = sentence;
+      view.startFields(firstDelimiterPos);
+      forEachField(sentence, [&](std::size_t start, std::size_t length)
+      {
+          if (view.fieldCount == SentenceView::maxFields)
+          {
+              throw std::length_error("Too many data fields for a SentenceView.");
+          }
+          view.endField(static_cast<std::uint16_t>(start + length));
+      });
+      return view;
+  }
+
+  SentenceStatus scanSentence(std::string_view candidateSentence, SentenceView & view)
+  {
+      return scanSentence(candidateSentence, view, TalkerSet::gps());
+  }
+
+  SentenceStatus scanSentence(std::string_view candidateSentence, SentenceView & view, const TalkerSet & talkers)
+  {
+      enum class State { start, talker, format, firstDelimiter, fields, checksumHigh, checksumLow, end };
+
+      if (candidateSentence.size() > UINT16_MAX) return SentenceStatus::malformed;
+
+      view.sentence = candidateSentence;
+
+      State state = State::start;
+      unsigned char totalXOR = 0; // XOR reduction of everything between the '$' and the '*'
+      int checksum = 0;
+
+      for (std::size_t i = 0; i < candidateSentence.size(); ++i)
+      {
+          const char c = candidateSentence[i];
+          switch (state)
+          {
+              case State::start:
+                  if (c != '$') return SentenceStatus::malformed;
+                  state = State::talker;
+                  break;
+
+              case State::talker:
+                  totalXOR ^= static_cast<unsigned char>(c);
+                  if (i + 1 == formatPos)
+                  {
+                      // Both characters of the talker ID are checked together.
+                      if (! talkers.contains(candidateSentence[talkerPos], c)) return SentenceStatus::malformed;
+                      state = State::format;
+                  }
+                  break;
+
+              case State::format:
+                  if (c < 'A' || c > 'Z') return SentenceStatus::malformed;
+                  totalXOR ^= static_cast<unsigned char>(c);
+                  if (i + 1 == firstDelimiterPos) state = State::firstDelimiter;
+                  break;
+
+              case State::firstDelimiter:
+                  // There must be at least one (possibly empty) data field.
+                  if (c != ',') return SentenceStatus::malformed;
+                  totalXOR ^= static_cast<unsigned char>(c);
+                  view.startFields(static_cast<std::uint16_t>(i));
+                  state = State::fields;
+                  break;
+
+              case State::fields:
+              {
+                  // Skip straight to the next delimiter, XORing the field contents on the way.
+                  i += ByteScan::findDelimiterXor(candidateSentence.data() + i, candidateSentence.size() - i, totalXOR);
+
+                  if (i == candidateSentence.size()) return SentenceStatus::malformed; // no '*'
+
+                  const char delimiter = candidateSentence[i];
+                  if (delimiter == '$') return SentenceStatus::malformed;
+                  if (delimiter == '\n')
+                  {
+                      // Not a delimiter within a sentence, just an ordinary field character.
+                      totalXOR ^= static_cast<unsigned char>(delimiter);
+                      break;
+                  }
+
+                  if (view.fieldCount == SentenceView::maxFields) return SentenceStatus::malformed;
+                  view.endField(static_cast<std::uint16_t>(i));
+
+                  if (delimiter == '*')
+                  {
+                      state = State::checksumHigh;
+                  }
+                  else
+                  {
+                      totalXOR ^= static_cast<unsigned char>(delimiter);
+                  }
+                  break;
+              }
+
+              case State::checksumHigh:
+              case State::checksumLow:
+              {
+                  const int digit = hexDigitValue(c);
+                  if (digit < 0) return SentenceStatus::malformed;
+                  checksum = checksum * 16 + digit;
+                  state = (state == State::checksumHigh) ? State::checksumLow : State::end;
+                  break;
+              }
+
+              case State::end:
+                  // Nothing may follow the checksum.
+                  return SentenceStatus::malformed;
+          }
+      }
+
+      if (state != State::end) return SentenceStatus::malformed;
+
+      if (totalXOR != checksum) return SentenceStatus::badChecksum;
+
+      if (! isSupportedSentenceFormat(view.format())) return SentenceStatus::unsupportedFormat;
+
+      return SentenceStatus::ok;
   }
 
   GPS::Position interpretSentenceData(SentenceData data)
   {
-      // Stub definition, needs implementing
-      return GPS::Earth::NorthPole;
+      return valueOrThrow(tryInterpretSentenceData(data));
+  }
+
+  GPS::Position interpretSentenceData(const SentenceView & sentence)
+  {
+      return valueOrThrow(tryInterpretSentenceData(sentence));
+  }
+
+  InterpretResult tryInterpretSentenceData(const SentenceData & data)
+  {
+      return interpretFields(data.format, SentenceFields(data));
+  }
+
+  InterpretResult tryInterpretSentenceData(const SentenceView & sentence)
+  {
+      return interpretFields(sentence.format(), SentenceFields(sentence));
+  }
+
+  InterpretResult tryInterpretSentenceData(const SentenceView & sentence, const DecodeQuery & query)
+  {
+      if (! query.acceptsFixQuality(query.minFixQuality == 0 ? 0 : fixQuality(sentence)))
+      {
+          return InterpretError::filteredOut;
+      }
+      if (query.restrictsTime() && ! query.acceptsTime(timeOfDay(sentence)))
+      {
+          return InterpretError::filteredOut;
+      }
+      return interpretFields(sentence.format(), SentenceFields(sentence), query);
+  }
+
+  double timeOfDay(const SentenceView & sentence)
+  {
+      const FormatDecoder * decoder = decoderFor(sentence.format());
+      if (decoder == nullptr) return GPS::PositionBatch::unknownTimeStamp;
+
+      double hhmmss;
+      if (! sentence.tryField(decoder->timeField, hhmmss) || hhmmss < 0)
+      {
+          return GPS::PositionBatch::unknownTimeStamp;
+      }
+
+      const double hours = std::floor(hhmmss / 10000);
+      const double minutes = std::floor(hhmmss / 100) - 100 * hours;
+      const double secs = hhmmss - 10000 * hours - 100 * minutes;
+      if (hours >= 24 || minutes >= 60 || secs >= 61) return GPS::PositionBatch::unknownTimeStamp; // 60 is a leap second
+
+      return 3600 * hours + 60 * minutes + secs;
+  }
+
+  std::uint8_t fixQuality(const SentenceView & sentence)
+  {
+      const FormatDecoder * decoder = decoderFor(sentence.format());
+      if (decoder == nullptr || decoder->fixQualityField >= sentence.numFields()) return GPS::PositionBatch::unknownFixQuality;
+
+      const std::string_view field = sentence.field(decoder->fixQualityField);
+      if (field.size() != 1) return GPS::PositionBatch::unknownFixQuality;
+
+      switch (field.front())
+      {
+          case 'A': return 1;
+          case 'V': return 0;
+          default:
+              if (field.front() >= '0' && field.front() <= '9') return static_cast<std::uint8_t>(field.front() - '0');
+              return GPS::PositionBatch::unknownFixQuality;
+      }
+  }
+
+  std::optional<std::tm> dateOf(const SentenceView & sentence)
+  {
+      const FormatDecoder * decoder = decoderFor(sentence.format());
+      if (decoder == nullptr || decoder->dateField >= sentence.numFields()) return std::nullopt;
+
+      const std::string_view ddmmyy = sentence.field(decoder->dateField);
+      if (ddmmyy.size() != 6) return std::nullopt;
+      for (char c : ddmmyy)
+      {
+          if (c < '0' || c > '9') return std::nullopt;
+      }
+      auto twoDigits = [&](std::size_t pos) { return (ddmmyy[pos] - '0') * 10 + (ddmmyy[pos + 1] - '0'); };
+
+      std::tm date = {};
+      date.tm_mday = twoDigits(0);
+      date.tm_mon = twoDigits(2) - 1;
+      const int year = twoDigits(4);
+      date.tm_year = (year < 80) ? year + 100 : year; // years since 1900
+      if (date.tm_mday < 1 || date.tm_mday > 31 || date.tm_mon < 0 || date.tm_mon > 11) return std::nullopt;
+
+      return date;
+  }
+
+  namespace
+  {
+      // The value of a decimal field of a supported sentence, if it has one.
+      std::optional<double> decimalField(const SentenceView & sentence, std::size_t FormatDecoder::* field)
+      {
+          const FormatDecoder * decoder = decoderFor(sentence.format());
+          if (decoder == nullptr) return std::nullopt;
+
+          double value;
+          if (! sentence.tryField(decoder->*field, value)) return std::nullopt;
+          return value;
+      }
+  }
+
+  std::optional<GPS::speed> groundSpeedOf(const SentenceView & sentence)
+  {
+      const double metresPerSecondPerKnot = 1852.0 / 3600.0;
+
+      const std::optional<double> knots = decimalField(sentence, &FormatDecoder::speedField);
+      if (! knots || *knots < 0) return std::nullopt;
+      return *knots * metresPerSecondPerKnot;
+  }
+
+  std::optional<GPS::degrees> courseOf(const SentenceView & sentence)
+  {
+      const std::optional<double> course = decimalField(sentence, &FormatDecoder::courseField);
+      if (! course || *course < 0 || *course > 360) return std::nullopt;
+      return course;
+  }
+
+  std::optional<GPS::Position> decodeLogLine(std::string_view line, SentenceView & sentence,
+                                             const TalkerSet & talkers, IngestStats & stats)
+  {
+      return decodeLogLine(line, sentence, talkers, stats, unrestricted);
+  }
+
+  std::optional<GPS::Position> decodeLogLine(std::string_view line, SentenceView & sentence,
+                                             const TalkerSet & talkers, IngestStats & stats,
+                                             const DecodeQuery & query)
+  {
+      ++stats.linesRead;
+
+      // NMEA 0183 receivers end each sentence with "\r\n", but lines are framed on '\n'.
+      if (! line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+      switch (scanSentence(line, sentence, talkers))
+      {
+          case SentenceStatus::ok:
+              break;
+          case SentenceStatus::malformed:
+              ++stats.malformed;
+              return std::nullopt;
+          case SentenceStatus::badChecksum:
+              ++stats.badChecksum;
+              return std::nullopt;
+          case SentenceStatus::unsupportedFormat:
+              ++stats.unsupportedFormat;
+              return std::nullopt;
+      }
+
+      const InterpretResult result = tryInterpretSentenceData(sentence, query);
+      if (! result)
+      {
+          if (result.error() == InterpretError::filteredOut)
+          {
+              ++stats.filtered;
+          }
+          else
+          {
+              ++stats.invalidFields;
+          }
+          return std::nullopt;
+      }
+
+      stats.addAccepted(sentence.format());
+      return *result;
+  }
+
+  namespace
+  {
+      /* Calls 'append(sentence,position)' with the Position from a line of a log, if it
+       * contains a valid sentence.
+       */
+      template <typename Appender>
+      void appendPositionFrom(std::string_view line, SentenceView & sentence,
+                              const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                              IngestStats & stats, const DecodeQuery & query, Appender append)
+      {
+          const std::optional<GPS::Position> position = decodeLogLine(line, sentence, talkers, stats, query);
+          if (! position) return;
+          append(sentence, *position);
+
+          if (talkerCounts != nullptr)
+          {
+              const std::string_view talker = sentence.talker();
+              talkerCounts->add(talker[0], talker[1]);
+          }
+      }
+
+      // Appends to a vector of Positions.
+      auto appendTo(std::vector<GPS::Position> & positions)
+      {
+          return [&positions](const SentenceView &, const GPS::Position & position)
+          {
+              positions.push_back(position);
+          };
+      }
+
+      // Appends to a PositionBatch, extracting only the optional columns that it has.
+      auto appendTo(GPS::PositionBatch & batch)
+      {
+          return [&batch](const SentenceView & sentence, const GPS::Position & position)
+          {
+              batch.push_back(position,
+                              batch.hasTimeStamps() ? timeOfDay(sentence) : GPS::PositionBatch::unknownTimeStamp,
+                              batch.hasFixQualities() ? fixQuality(sentence) : GPS::PositionBatch::unknownFixQuality);
+          };
+      }
+
+      /* The number of days from 1970-01-01 to a date in the proleptic Gregorian calendar.
+       * The day of the month may be out of its range (e.g. 0 or 32), moving into the
+       * adjacent month.  (The algorithm of H. Hinnant, "chrono-Compatible Low-Level Date
+       * Algorithms".)
+       */
+      long daysFromCivil(long year, int month, int day)
+      {
+          year -= (month <= 2) ? 1 : 0;
+          const long era = (year >= 0 ? year : year - 399) / 400;
+          const long yearOfEra = year - era * 400;
+          const long dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+          const long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+          return era * 146097 + dayOfEra - 719468;
+      }
+
+      // Sets the date fields of a std::tm from a number of days since 1970-01-01.
+      void civilFromDays(long days, std::tm & date)
+      {
+          const long shifted = days + 719468;
+          const long era = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+          const long dayOfEra = shifted - era * 146097;
+          const long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+          const long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+          const long shiftedMonth = (5 * dayOfYear + 2) / 153;
+          const int month = static_cast<int>(shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+          const long year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+          date.tm_year = static_cast<int>(year - 1900);
+          date.tm_mon = month - 1;
+          date.tm_mday = static_cast<int>(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+          date.tm_wday = static_cast<int>((days % 7 + 11) % 7); // 1970-01-01 was a Thursday
+          date.tm_yday = static_cast<int>(days - daysFromCivil(year, 1, 1));
+      }
+
+      /* Collects TrackPoints, dating each one with the most recent RMC date.
+       * Points that precede the first RMC date are dated retrospectively, once it arrives.
+       */
+      class TrackPointCollector
+      {
+        public:
+          explicit TrackPointCollector(std::vector<GPS::TrackPoint> & points) : points(points) {}
+
+          void add(const SentenceView & sentence, const GPS::Position & position)
+          {
+              const double time = timeOfDay(sentence);
+              if (std::isnan(time)) return; // Skip sentences that cannot be placed in time.
+
+              const std::optional<std::tm> sentenceDate = dateOf(sentence);
+              if (sentenceDate)
+              {
+                  const bool firstDate = ! date;
+                  date = sentenceDate;
+                  dateTime = time;
+                  if (firstDate)
+                  {
+                      for (std::size_t i = 0; i < undatedTimes.size(); ++i)
+                      {
+                          points[i].dateTime = dateTimeAt(undatedTimes[i]);
+                      }
+                      undatedTimes.clear();
+                  }
+              }
+
+              points.push_back({position, "", {}});
+              if (date)
+              {
+                  points.back().dateTime = dateTimeAt(time);
+              }
+              else
+              {
+                  undatedTimes.push_back(time);
+              }
+          }
+
+          // Throws a std::domain_error exception if some points could not be dated.
+          void finish() const
+          {
+              if (! undatedTimes.empty()) throw std::domain_error("No RMC sentence with a valid date found in the log.");
+          }
+
+        private:
+          std::vector<GPS::TrackPoint> & points;
+
+          std::optional<std::tm> date; // the most recent RMC date...
+          double dateTime = 0;         // ...and the time of day of that RMC sentence
+
+          std::vector<double> undatedTimes; // for the points preceding the first date
+
+          /* Combines the current date with a time of day.  A time of day more than 12 hours
+           * away from that of the dating RMC sentence is taken to be on the adjacent day,
+           * to cope with sentences either side of midnight.
+           */
+          std::tm dateTimeAt(double time) const
+          {
+              const double halfDay = 12 * 60 * 60;
+              std::tm result = *date;
+              if (time - dateTime < -halfDay) ++result.tm_mday;
+              if (time - dateTime > halfDay) --result.tm_mday;
+
+              const long wholeSeconds = static_cast<long>(time); // std::tm has no fractional seconds
+              result.tm_hour = static_cast<int>(wholeSeconds / 3600);
+              result.tm_min = static_cast<int>(wholeSeconds / 60 % 60);
+              result.tm_sec = static_cast<int>(wholeSeconds % 60);
+
+              // Normalise the date after any adjustment of the day.
+              civilFromDays(daysFromCivil(result.tm_year + 1900L, result.tm_mon + 1, result.tm_mday), result);
+              return result;
+          }
+      };
+
+      auto appendTo(TrackPointCollector & collector)
+      {
+          return [&collector](const SentenceView & sentence, const GPS::Position & position)
+          {
+              collector.add(sentence, position);
+          };
+      }
+
+      // Merges the sentences of each epoch into a Fix.
+      auto appendTo(EpochFusion & fusion)
+      {
+          return [&fusion](const SentenceView & sentence, const GPS::Position & position)
+          {
+              fusion.add(sentence, position);
+          };
+      }
+
+      // Times a decoding, adding the statistics to the caller's (if any) at the end.
+      class IngestTimer
+      {
+        public:
+          explicit IngestTimer(IngestStats * callerStats)
+              : callerStats(callerStats), start(std::chrono::steady_clock::now())
+          {}
+
+          ~IngestTimer()
+          {
+              if (callerStats == nullptr) return;
+              stats.elapsed = std::chrono::steady_clock::now() - start;
+              *callerStats += stats;
+          }
+
+          IngestStats stats;
+
+        private:
+          IngestStats * callerStats;
+          std::chrono::steady_clock::time_point start;
+      };
+
+      template <typename Output>
+      void decodeLog(std::istream & log, const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                     IngestStats * ingestStats, Output & output, const DecodeQuery & query = unrestricted)
+      {
+          IngestTimer timer(ingestStats);
+
+          // Reused for every line, so its capacity only grows to the longest line.
+          std::string line;
+          SentenceView sentence;
+
+          while (std::getline(log, line))
+          {
+              // The final line may not have had a line break.
+              timer.stats.bytesRead += line.size() + (log.eof() ? 0 : 1);
+              appendPositionFrom(line, sentence, talkers, talkerCounts, timer.stats, query, appendTo(output));
+          }
+      }
+
+      template <typename Output>
+      void decodeBuffer(std::string_view buffer, const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                        IngestStats * ingestStats, Output & output, const DecodeQuery & query = unrestricted)
+      {
+          IngestTimer timer(ingestStats);
+          timer.stats.bytesRead += buffer.size();
+
+          SentenceView sentence;
+
+          while (! buffer.empty())
+          {
+              const std::size_t lineEnd = buffer.find('\n');
+              appendPositionFrom(buffer.substr(0, lineEnd), sentence, talkers, talkerCounts, timer.stats, query,
+                                 appendTo(output));
+              buffer.remove_prefix(lineEnd == std::string_view::npos ? buffer.size() : lineEnd + 1);
+          }
+      }
   }
 
   std::vector<GPS::Position> positionsFromLog(std::istream & log)
   {
-      // Stub definition, needs implementing
-      return {};
+      return positionsFromLog(log, TalkerSet::gps());
+  }
+
+  std::vector<GPS::Position> positionsFromLog(std::istream & log, const TalkerSet & talkers,
+                                              TalkerCounts * talkerCounts, IngestStats * ingestStats)
+  {
+      std::vector<GPS::Position> positions;
+      decodeLog(log, talkers, talkerCounts, ingestStats, positions);
+      return positions;
+  }
+
+  std::vector<GPS::Position> positionsFromBuffer(std::string_view buffer)
+  {
+      return positionsFromBuffer(buffer, TalkerSet::gps());
+  }
+
+  std::vector<GPS::Position> positionsFromBuffer(std::string_view buffer, const TalkerSet & talkers,
+                                                 TalkerCounts * talkerCounts, IngestStats * ingestStats)
+  {
+      std::vector<GPS::Position> positions;
+      decodeBuffer(buffer, talkers, talkerCounts, ingestStats, positions);
+      return positions;
+  }
+
+  void positionsFromLogInto(std::istream & log, GPS::PositionBatch & batch)
+  {
+      positionsFromLogInto(log, batch, TalkerSet::gps());
+  }
+
+  void positionsFromLogInto(std::istream & log, GPS::PositionBatch & batch,
+                            const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                            IngestStats * ingestStats)
+  {
+      decodeLog(log, talkers, talkerCounts, ingestStats, batch);
+  }
+
+  void positionsFromBufferInto(std::string_view buffer, GPS::PositionBatch & batch)
+  {
+      positionsFromBufferInto(buffer, batch, TalkerSet::gps());
+  }
+
+  void positionsFromBufferInto(std::string_view buffer, GPS::PositionBatch & batch,
+                               const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                               IngestStats * ingestStats)
+  {
+      decodeBuffer(buffer, talkers, talkerCounts, ingestStats, batch);
+  }
+
+  std::vector<GPS::Position> positionsFromLog(std::istream & log, const DecodeQuery & query,
+                                              const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                                              IngestStats * ingestStats)
+  {
+      std::vector<GPS::Position> positions;
+      decodeLog(log, talkers, talkerCounts, ingestStats, positions, query);
+      return positions;
+  }
+
+  std::vector<GPS::Position> positionsFromBuffer(std::string_view buffer, const DecodeQuery & query,
+                                                 const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                                                 IngestStats * ingestStats)
+  {
+      std::vector<GPS::Position> positions;
+      decodeBuffer(buffer, talkers, talkerCounts, ingestStats, positions, query);
+      return positions;
   }
 
+  void positionsFromLogInto(std::istream & log, GPS::PositionBatch & batch, const DecodeQuery & query,
+                            const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                            IngestStats * ingestStats)
+  {
+      decodeLog(log, talkers, talkerCounts, ingestStats, batch, query);
+  }
+
+  void positionsFromBufferInto(std::string_view buffer, GPS::PositionBatch & batch, const DecodeQuery & query,
+                               const TalkerSet & talkers, TalkerCounts * talkerCounts,
+                               IngestStats * ingestStats)
+  {
+      decodeBuffer(buffer, talkers, talkerCounts, ingestStats, batch, query);
+  }
+
+  std::vector<GPS::TrackPoint> trackPointsFromLog(std::istream & log)
+  {
+      return trackPointsFromLog(log, TalkerSet::gps());
+  }
+
+  std::vector<GPS::TrackPoint> trackPointsFromLog(std::istream & log, const TalkerSet & talkers,
+                                                  TalkerCounts * talkerCounts)
+  {
+      std::vector<GPS::TrackPoint> points;
+      TrackPointCollector collector(points);
+      decodeLog(log, talkers, talkerCounts, nullptr, collector);
+      collector.finish();
+      return points;
+  }
+
+  std::vector<GPS::TrackPoint> trackPointsFromBuffer(std::string_view buffer)
+  {
+      return trackPointsFromBuffer(buffer, TalkerSet::gps());
+  }
+
+  std::vector<GPS::TrackPoint> trackPointsFromBuffer(std::string_view buffer, const TalkerSet & talkers,
+                                                     TalkerCounts * talkerCounts)
+  {
+      std::vector<GPS::TrackPoint> points;
+      TrackPointCollector collector(points);
+      decodeBuffer(buffer, talkers, talkerCounts, nullptr, collector);
+      collector.finish();
+      return points;
+  }
+
+  std::vector<Fix> fixesFromLog(std::istream & log)
+  {
+      return fixesFromLog(log, TalkerSet::gps());
+  }
+
+  std::vector<Fix> fixesFromLog(std::istream & log, const TalkerSet & talkers, TalkerCounts * talkerCounts)
+  {
+      std::vector<Fix> fixes;
+      EpochFusion fusion([&fixes](const Fix & fix) { fixes.push_back(fix); });
+      decodeLog(log, talkers, talkerCounts, nullptr, fusion);
+      fusion.finish();
+      return fixes;
+  }
 }
@@ -1,5 +1,8 @@
 #include <cassert>
+#include <cctype>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
 #include <sstream>
 #include <stdexcept>
 
@@ -9,85 +12,254 @@
 
 namespace GPS
 {
-  Position::Position(degrees lat, degrees lon, metres ele)
+  namespace
   {
-      if (std::abs(lat) > poleLatitude)
-          throw std::invalid_argument("Latitude values must not exceed " + std::to_string(poleLatitude) + " degrees.");
+      // 'N' means a positive angle, 'S' a negative one.
+      degrees applyNorthing(degrees lat, char northing)
+      {
+          switch (northing)
+          {
+              case 'N': return lat;
+              case 'S': return -lat;
+              default: throw std::invalid_argument(northing + std::string(" is an invalid North/South bearing character in DDM format.  Only 'N' or 'S' accepted."));
+          }
+      }
+
+      // 'E' means a positive angle, 'W' a negative one.
+      degrees applyEasting(degrees lon, char easting)
+      {
+          switch (easting)
+          {
+              case 'E': return lon;
+              case 'W': return -lon;
+              default: throw std::invalid_argument(easting + std::string(" is an invalid East/West bearing character in DDM format.  Only 'E' or 'W' accepted."));
+          }
+      }
 
-      if (std::abs(lon) > antiMeridianLongitude)
-          throw std::invalid_argument("Longitude values must not exceed " + std::to_string(antiMeridianLongitude) + " degrees.");
+      // Exactly representable powers of ten.
+      const double powersOfTen[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                     1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                     1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+      const std::uint64_t maxExactInteger = std::uint64_t(1) << 53;
+
+      /* Converts the leading number of a string as std::stod() does, including its exceptions,
+       * but without allocating or consulting the locale.
+       */
+      double stringToDouble(std::string_view str)
+      {
+          std::size_t pos = 0;
+          while (pos < str.size() && std::isspace(static_cast<unsigned char>(str[pos]))) ++pos;
+          if (pos < str.size() && str[pos] == '+' && (pos + 1 == str.size() || str[pos + 1] != '-')) ++pos;
+
+          double value;
+          const std::from_chars_result result = std::from_chars(str.data() + pos, str.data() + str.size(), value);
+          if (result.ec == std::errc::invalid_argument) throw std::invalid_argument("'" + std::string(str) + "' is not a number.");
+          if (result.ec == std::errc::result_out_of_range) throw std::out_of_range("'" + std::string(str) + "' is out of range.");
+          return value;
+      }
 
-      this->lat = lat;
-      this->lon = lon;
-      this->ele = ele;
+      degrees ddmValueTodd(double ddm)
+      {
+          double degs = std::floor(ddm / 100);
+          double mins = ddm - 100 * degs;
+          return degs + mins / 60.0; // converts minutes (1/60th) to decimal fractions of a degree
+      }
   }
 
   Position::Position(std::string latStr,
                      std::string lonStr,
                      std::string eleStr)
-      : Position(std::stod(latStr), std::stod(lonStr), std::stod(eleStr)) {}
+      : Position(stringToDouble(latStr), stringToDouble(lonStr), stringToDouble(eleStr)) {}
 
   Position::Position(std::string ddmLatStr, char northing,
                      std::string ddmLonStr, char easting,
                      std::string eleStr)
-      : Position(ddmTodd(ddmLatStr), ddmTodd(ddmLonStr), std::stod(eleStr))
+      : Position(ddmTodd(ddmLatStr), ddmTodd(ddmLonStr), stringToDouble(eleStr))
+  {
+      if (lat < 0)
+          throw std::invalid_argument("Latitude values must be positive when accompanied by a N/S bearing.");
+
+      if (lon < 0)
+          throw std::invalid_argument("Longitude values must be positive when accompanied by an E/W bearing.");
+
+      lat = applyNorthing(lat, northing);
+      lon = applyEasting(lon, easting);
+  }
+
+  Position Position::fromDDM(std::string_view ddmLatStr, char northing,
+                             std::string_view ddmLonStr, char easting,
+                             std::string_view eleStr)
   {
+      const degrees lat = parseDDM(ddmLatStr);
+      const degrees lon = parseDDM(ddmLonStr);
+      const metres ele = parseDecimal(eleStr);
+
       if (lat < 0)
           throw std::invalid_argument("Latitude values must be positive when accompanied by a N/S bearing.");
 
       if (lon < 0)
           throw std::invalid_argument("Longitude values must be positive when accompanied by an E/W bearing.");
 
+      return Position(applyNorthing(lat, northing), applyEasting(lon, easting), ele);
+  }
+
+  std::optional<Position> Position::tryFromDDM(std::string_view ddmLatStr, char northing,
+                                               std::string_view ddmLonStr, char easting,
+                                               std::string_view eleStr)
+  {
+      double ddmLat, ddmLon, ele;
+      if (! tryParseDecimal(ddmLatStr, ddmLat) || ! tryParseDecimal(ddmLonStr, ddmLon) || ! tryParseDecimal(eleStr, ele))
+      {
+          return std::nullopt;
+      }
+
+      // The same checks as fromDDM(), in the same order.
+      degrees lat = ddmValueTodd(ddmLat);
+      degrees lon = ddmValueTodd(ddmLon);
+      if (lat < 0 || lon < 0) return std::nullopt;
+
       switch (northing)
       {
-          case 'N': break;             // 'N' means positive angle, so no change
-          case 'S': lat = -lat; break; // 'S' means negative angle
-          default: throw std::invalid_argument(northing + std::string(" is an invalid North/South bearing character in DDM format.  Only 'N' or 'S' accepted."));
+          case 'N': break;
+          case 'S': lat = -lat; break;
+          default: return std::nullopt;
       }
 
       switch (easting)
       {
-          case 'E': break;             // 'E' means positive angle, so no change
-          case 'W': lon = -lon; break; // 'W' means negative angle
-          default: throw std::invalid_argument(easting + std::string(" is an invalid East/West bearing character in DDM format.  Only 'E' or 'W' accepted."));
+          case 'E': break;
+          case 'W': lon = -lon; break;
+          default: return std::nullopt;
       }
 
+      if (std::abs(lat) > poleLatitude || std::abs(lon) > antiMeridianLongitude) return std::nullopt;
+
+      return Position(lat, lon, ele);
   }
 
-  degrees Position::latitude() const
+  metres Position::horizontalDistanceBetween(Position p1, Position p2)
+  /*
+   * See: http://en.wikipedia.org/wiki/Law_of_haversines
+   */
+  {
+      const radians lat1 = degToRad(p1.latitude());
+      const radians lat2 = degToRad(p2.latitude());
+      const radians lon1 = degToRad(p1.longitude());
+      const radians lon2 = degToRad(p2.longitude());
+
+      double h = sinSqr((lat2-lat1)/2) + Trig::cos<trigPrecision>(lat1)*Trig::cos<trigPrecision>(lat2)*sinSqr((lon2-lon1)/2);
+      return 2 * Earth::meanRadius * Trig::asin<trigPrecision>(std::sqrt(h));
+  }
+
+  PreparedPosition::PreparedPosition(Position p)
+      : pos(p), lat(degToRad(p.latitude())), lon(degToRad(p.longitude())), cosLat(Trig::cos<trigPrecision>(lat)) {}
+
+  const Position & PreparedPosition::position() const
+  {
+      return pos;
+  }
+
+  radians PreparedPosition::latitudeRadians() const
   {
       return lat;
   }
 
-  degrees Position::longitude() const
+  radians PreparedPosition::longitudeRadians() const
   {
       return lon;
   }
 
-  metres Position::elevation() const
+  double PreparedPosition::cosLatitude() const
   {
-      return ele;
+      return cosLat;
   }
 
-  metres Position::horizontalDistanceBetween(Position p1, Position p2)
-  /*
-   * See: http://en.wikipedia.org/wiki/Law_of_haversines
-   */
+  metres PreparedPosition::horizontalDistanceBetween(const PreparedPosition & p1, const PreparedPosition & p2)
   {
-      const radians lat1 = degToRad(p1.latitude());
-      const radians lat2 = degToRad(p2.latitude());
-      const radians lon1 = degToRad(p1.longitude());
-      const radians lon2 = degToRad(p2.longitude());
+      // The same calculation as Position::horizontalDistanceBetween(), so that the results are identical.
+      double h = sinSqr((p2.lat-p1.lat)/2) + p1.cosLat*p2.cosLat*sinSqr((p2.lon-p1.lon)/2);
+      return 2 * Earth::meanRadius * Trig::asin<trigPrecision>(std::sqrt(h));
+  }
 
-      double h = sinSqr((lat2-lat1)/2) + std::cos(lat1)*std::cos(lat2)*sinSqr((lon2-lon1)/2);
-      return 2 * Earth::meanRadius * std::asin(std::sqrt(h));
+  metres PreparedPosition::horizontalDistanceBetween(const PreparedPosition & p1, Position p2)
+  {
+      return horizontalDistanceBetween(p1, PreparedPosition(p2));
   }
 
   degrees ddmTodd(std::string ddmStr)
   {
-      double ddm  = std::stod(ddmStr);
-      double degs = std::floor(ddm / 100);
-      double mins = ddm - 100 * degs;
-      return degs + mins / 60.0; // converts minutes (1/60th) to decimal fractions of a degree
+      return ddmValueTodd(stringToDouble(ddmStr));
+  }
+
+  double parseDecimal(std::string_view str)
+  {
+      double value;
+      if (! tryParseDecimal(str, value)) throw std::invalid_argument("'" + std::string(str) + "' is not a decimal number.");
+      return value;
+  }
+
+  bool tryParseDecimal(std::string_view str, double & value)
+  {
+      std::size_t pos = 0;
+      bool negative = false;
+      if (! str.empty() && (str[0] == '-' || str[0] == '+'))
+      {
+          negative = (str[0] == '-');
+          pos = 1;
+      }
+      const std::string_view unsignedStr = str.substr(pos);
+
+      // Accumulate all the digits into an integer, ignoring the decimal point.
+      std::uint64_t mantissa = 0;
+      unsigned int significantDigits = 0;
+      unsigned int fractionalDigits = 0;
+      bool seenDigit = false;
+      bool seenPoint = false;
+      for (; pos < str.size(); ++pos)
+      {
+          const char c = str[pos];
+          if (c == '.' && ! seenPoint)
+          {
+              seenPoint = true;
+              continue;
+          }
+          if (c < '0' || c > '9') return false;
+
+          seenDigit = true;
+          if (seenPoint) ++fractionalDigits;
+          if (mantissa != 0 || c != '0') ++significantDigits; // leading zeros are not significant
+          if (significantDigits <= 19) mantissa = mantissa * 10 + (c - '0');
+      }
+      if (! seenDigit) return false;
+
+      if (significantDigits <= 19 && mantissa <= maxExactInteger && fractionalDigits <= 22)
+      {
+          // Both operands are exact, so the (correctly rounded) division gives the same
+          // result as a correctly rounded string conversion.
+          value = static_cast<double>(mantissa) / powersOfTen[fractionalDigits];
+      }
+      else
+      {
+          // Too many digits for the fast path; fall back on the (correctly rounded) standard library.
+          const std::from_chars_result result = std::from_chars(unsignedStr.data(), unsignedStr.data() + unsignedStr.size(),
+                                                                value, std::chars_format::fixed);
+          if (result.ec != std::errc()) return false;
+      }
+      if (negative) value = -value;
+      return true;
+  }
+
+  degrees parseDDM(std::string_view ddmStr)
+  {
+      return ddmValueTodd(parseDecimal(ddmStr));
+  }
+
+  bool tryParseDDM(std::string_view ddmStr, degrees & value)
+  {
+      double ddm;
+      if (! tryParseDecimal(ddmStr, ddm)) return false;
+      value = ddmValueTodd(ddm);
+      return true;
   }
 }
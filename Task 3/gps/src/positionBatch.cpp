@@ -0,0 +1,109 @@
+#include <stdexcept>
+
+#include "positionBatch.h"
+
+namespace GPS
+{
+  PositionBatch::PositionBatch(bool hasTimeStamps, bool hasFixQualities)
+      : withTimeStamps(hasTimeStamps), withFixQualities(hasFixQualities)
+  {}
+
+  std::size_t PositionBatch::size() const
+  {
+      return lats.size();
+  }
+
+  bool PositionBatch::empty() const
+  {
+      return lats.empty();
+  }
+
+  void PositionBatch::reserve(std::size_t capacity)
+  {
+      lats.reserve(capacity);
+      lons.reserve(capacity);
+      eles.reserve(capacity);
+      if (withTimeStamps) times.reserve(capacity);
+      if (withFixQualities) qualities.reserve(capacity);
+  }
+
+  void PositionBatch::clear()
+  {
+      lats.clear();
+      lons.clear();
+      eles.clear();
+      times.clear();
+      qualities.clear();
+  }
+
+  void PositionBatch::push_back(const Position & position, double timeStamp, std::uint8_t fixQuality)
+  {
+      lats.push_back(position.latitude());
+      lons.push_back(position.longitude());
+      eles.push_back(position.elevation());
+      if (withTimeStamps) times.push_back(timeStamp);
+      if (withFixQualities) qualities.push_back(fixQuality);
+  }
+
+  void PositionBatch::append(std::size_t count, const degrees * newLats, const degrees * newLons,
+                             const metres * newEles, const double * newTimeStamps)
+  {
+      lats.insert(lats.end(), newLats, newLats + count);
+      lons.insert(lons.end(), newLons, newLons + count);
+      eles.insert(eles.end(), newEles, newEles + count);
+      if (withTimeStamps)
+      {
+          if (newTimeStamps != nullptr)
+          {
+              times.insert(times.end(), newTimeStamps, newTimeStamps + count);
+          }
+          else
+          {
+              times.insert(times.end(), count, unknownTimeStamp);
+          }
+      }
+      if (withFixQualities) qualities.insert(qualities.end(), count, unknownFixQuality);
+  }
+
+  Position PositionBatch::operator[](std::size_t index) const
+  {
+      return Position(lats[index], lons[index], eles[index]);
+  }
+
+  const std::vector<degrees> & PositionBatch::latitudes() const
+  {
+      return lats;
+  }
+
+  const std::vector<degrees> & PositionBatch::longitudes() const
+  {
+      return lons;
+  }
+
+  const std::vector<metres> & PositionBatch::elevations() const
+  {
+      return eles;
+  }
+
+  bool PositionBatch::hasTimeStamps() const
+  {
+      return withTimeStamps;
+  }
+
+  bool PositionBatch::hasFixQualities() const
+  {
+      return withFixQualities;
+  }
+
+  const std::vector<double> & PositionBatch::timeStamps() const
+  {
+      if (! withTimeStamps) throw std::domain_error("This batch has no time stamps.");
+      return times;
+  }
+
+  const std::vector<std::uint8_t> & PositionBatch::fixQualities() const
+  {
+      if (! withFixQualities) throw std::domain_error("This batch has no fix qualities.");
+      return qualities;
+  }
+}
@@ -9,13 +9,20 @@
 
 using namespace GPS;
 
-Route::Route(std::vector<RoutePoint> routePointsInput)
+Route::Route(std::vector<RoutePoint> routePointsInput, const DistanceModel & distanceModel)
+    : model(&distanceModel)
 {
     if (routePointsInput.empty())
     {
         throw std::invalid_argument("Invalid vector of RoutePoints - Routes must contain at least one point.");
     }
     routePoints.insert(routePoints.end(), routePointsInput.begin(), routePointsInput.end());
+    preparePositions();
+}
+
+const DistanceModel & Route::distanceModel() const
+{
+    return *model;
 }
 
 unsigned int Route::numPoints() const
@@ -29,11 +36,13 @@ metres Route::totalLength() const
 
     metres lengthSoFar = 0.0;
 
+    const std::vector<metres> legLengths = horizontalLegLengths();
+    std::vector<metres>::const_iterator leg = legLengths.begin();
     std::list<RoutePoint>::const_iterator currentPoint = routePoints.begin();
     std::list<RoutePoint>::const_iterator nextPoint = std::next(currentPoint);
-    for ( ; nextPoint != routePoints.end(); ++currentPoint, ++nextPoint)
+    for ( ; nextPoint != routePoints.end(); ++currentPoint, ++nextPoint, ++leg)
     {
-        metres deltaH = Position::horizontalDistanceBetween(currentPoint->position,nextPoint->position);
+        metres deltaH = *leg;
         metres deltaV = nextPoint->position.elevation() - currentPoint->position.elevation();
         lengthSoFar += pythagoras(deltaH,deltaV);
     }
@@ -48,7 +57,7 @@ metres Route::netLength() const
     const Position & start  = routePoints.front().position;
     const Position & finish = routePoints.back().position;
 
-    metres deltaH = Position::horizontalDistanceBetween(start,finish);
+    metres deltaH = model->horizontalDistanceBetween(PreparedPosition(start),PreparedPosition(finish));
     metres deltaV = start.elevation() - finish.elevation();
     return pythagoras(deltaH,deltaV);
 }
@@ -87,14 +96,16 @@ degrees Route::maxGradient() const
 
     degrees maxGrad = -halfRotation/2; // minimum possible gradient value
 
+    const std::vector<metres> legLengths = horizontalLegLengths();
+    std::vector<metres>::const_iterator leg = legLengths.begin();
     for (std::list<RoutePoint>::const_iterator current = routePoints.begin(),
                                                next = std::next(current);
          next != routePoints.end();
-         ++current, ++next)
+         ++current, ++next, ++leg)
     {
-        metres deltaH = Position::horizontalDistanceBetween(current->position,next->position);
+        metres deltaH = *leg;
         metres deltaV = next->position.elevation() - current->position.elevation();
-        degrees grad = radToDeg(std::atan(deltaV/deltaH));
+        degrees grad = radToDeg(Trig::atan<trigPrecision>(deltaV/deltaH));
         maxGrad = std::max(maxGrad,grad);
     }
 
@@ -109,14 +120,16 @@ degrees Route::minGradient() const
 
     degrees minGrad = halfRotation/2; // maximum possible gradient value
 
+    const std::vector<metres> legLengths = horizontalLegLengths();
+    std::vector<metres>::const_iterator leg = legLengths.begin();
     for (std::list<RoutePoint>::const_iterator current = routePoints.begin(),
                                                next = std::next(current);
          next != routePoints.end();
-         ++current, ++next)
+         ++current, ++next, ++leg)
     {
-        metres deltaH = Position::horizontalDistanceBetween(current->position,next->position);
+        metres deltaH = *leg;
         metres deltaV = next->position.elevation() - current->position.elevation();
-        degrees grad = radToDeg(std::atan(deltaV/deltaH));
+        degrees grad = radToDeg(Trig::atan<trigPrecision>(deltaV/deltaH));
         minGrad = std::min(minGrad,grad);
     }
 
@@ -131,14 +144,16 @@ degrees Route::steepestGradient() const
 
     degrees steepestGrad = 0; // minimum possible gradient value
 
+    const std::vector<metres> legLengths = horizontalLegLengths();
+    std::vector<metres>::const_iterator leg = legLengths.begin();
     for (std::list<RoutePoint>::const_iterator current = routePoints.begin(),
                                                next = std::next(current);
          next != routePoints.end();
-         ++current, ++next)
+         ++current, ++next, ++leg)
     {
-        metres deltaH = Position::horizontalDistanceBetween(current->position,next->position);
+        metres deltaH = *leg;
         metres deltaV = next->position.elevation() - current->position.elevation();
-        degrees grad = radToDeg(std::atan(deltaV/deltaH));
+        degrees grad = radToDeg(Trig::atan<trigPrecision>(deltaV/deltaH));
         if (std::abs(grad) > std::abs(steepestGrad))
         {
             steepestGrad = grad;
@@ -307,11 +322,14 @@ RoutePoint Route::nearestPointTo(Position targetPosition) const
 {
     assert(! routePoints.empty());
 
+    const PreparedPosition preparedTarget(targetPosition);
+    std::vector<PreparedPosition>::const_iterator preparedPoint = preparedPositions.begin();
+
     RoutePoint nearestPointSoFar = routePoints.front();
-    metres shortestDistanceSoFar = Position::horizontalDistanceBetween(nearestPointSoFar.position, targetPosition);
+    metres shortestDistanceSoFar = model->horizontalDistanceBetween(*preparedPoint, preparedTarget);
     for (const RoutePoint& currentPoint : routePoints)
     {
-        metres currentDistance = Position::horizontalDistanceBetween(currentPoint.position, targetPosition);
+        metres currentDistance = model->horizontalDistanceBetween(*preparedPoint++, preparedTarget);
         if (currentDistance < shortestDistanceSoFar)
         {
             nearestPointSoFar = currentPoint;
@@ -325,11 +343,14 @@ RoutePoint Route::farthestPointFrom(Position avoidedPosition) const
 {
     assert(! routePoints.empty());
 
+    const PreparedPosition preparedAvoided(avoidedPosition);
+    std::vector<PreparedPosition>::const_iterator preparedPoint = preparedPositions.begin();
+
     RoutePoint farthestPointSoFar = routePoints.front();
-    metres longestDistanceSoFar = Position::horizontalDistanceBetween(farthestPointSoFar.position, avoidedPosition);
+    metres longestDistanceSoFar = model->horizontalDistanceBetween(*preparedPoint, preparedAvoided);
     for (const RoutePoint& currentPoint : routePoints)
     {
-        metres currentDistance = Position::horizontalDistanceBetween(currentPoint.position, avoidedPosition);
+        metres currentDistance = model->horizontalDistanceBetween(*preparedPoint++, preparedAvoided);
         if (currentDistance > longestDistanceSoFar)
         {
             farthestPointSoFar = currentPoint;
@@ -338,3 +359,39 @@ RoutePoint Route::farthestPointFrom(Position avoidedPosition) const
     }
     return farthestPointSoFar;
 }
+
+void Route::preparePositions()
+{
+    preparedPositions.clear();
+    latitudes.clear();
+    longitudes.clear();
+    preparedPositions.reserve(routePoints.size());
+    latitudes.reserve(routePoints.size());
+    longitudes.reserve(routePoints.size());
+    for (const RoutePoint& routePoint : routePoints)
+    {
+        preparedPositions.emplace_back(routePoint.position);
+        latitudes.push_back(routePoint.position.latitude());
+        longitudes.push_back(routePoint.position.longitude());
+    }
+}
+
+std::vector<metres> Route::horizontalLegLengths() const
+{
+    assert(! routePoints.empty());
+
+    std::vector<metres> legLengths(routePoints.size() - 1);
+
+    if (! model->horizontalDistances)
+    {
+        for (std::size_t i = 0; i < legLengths.size(); ++i)
+        {
+            legLengths[i] = model->horizontalDistanceBetween(preparedPositions[i], preparedPositions[i+1]);
+        }
+        return legLengths;
+    }
+
+    model->horizontalDistances(latitudes.data(), longitudes.data(), latitudes.data() + 1, longitudes.data() + 1,
+                               legLengths.data(), legLengths.size());
+    return legLengths;
+}
@@ -10,8 +10,10 @@ using namespace GPS;
 using std::chrono::seconds;
 using std::chrono::duration_cast;
 
-Track::Track(std::vector<TrackPoint> trackPoints, metres granularity)
+Track::Track(std::vector<TrackPoint> trackPoints, metres granularity, const DistanceModel & distanceModel)
 {
+    model = &distanceModel;
+
     for (const TrackPoint& trackPoint : trackPoints)
     {
         routePoints.push_back({trackPoint.position,trackPoint.name});
@@ -45,6 +47,8 @@ void Track::setGranularity(metres newGranularity)
             }
         }
     }
+
+    preparePositions();
 }
 
 seconds Track::totalTime() const
@@ -86,17 +90,19 @@ speed Track::maxSpeed() const
 
     speed ms = 0;
 
+    const std::vector<metres> legLengths = horizontalLegLengths();
+    std::vector<metres>::const_iterator leg = legLengths.begin();
     std::list<RoutePoint>::const_iterator currentPoint = routePoints.begin();
     std::list<RoutePoint>::const_iterator nextPoint = std::next(currentPoint);
     std::list<TimeStamp>::const_iterator currentTimeStamp = timeStamps.begin();
     std::list<TimeStamp>::const_iterator nextTimeStamp = std::next(currentTimeStamp);
-    for (; nextPoint != routePoints.end(); ++currentPoint, ++nextPoint, ++currentTimeStamp, ++nextTimeStamp)
+    for (; nextPoint != routePoints.end(); ++currentPoint, ++nextPoint, ++currentTimeStamp, ++nextTimeStamp, ++leg)
     {
         seconds time = duration_cast<seconds>(nextTimeStamp->arrival - currentTimeStamp->departure);
 
         if (time == seconds::zero()) throw std::domain_error("Cannot compute speed over a zero duration.");
 
-        metres deltaH = Position::horizontalDistanceBetween(currentPoint->position,nextPoint->position);
+        metres deltaH = *leg;
         metres deltaV = nextPoint->position.elevation() - currentPoint->position.elevation();
         metres distance = pythagoras(deltaH,deltaV);
         ms = std::max(ms,distance/time.count());
@@ -163,9 +169,12 @@ speed Track::maxRateOfDescent() const
 
 std::string Track::findNameOf(Position soughtPosition) const
 {
+    const PreparedPosition preparedSought(soughtPosition);
+    std::vector<PreparedPosition>::const_iterator preparedPoint = preparedPositions.begin();
+
     for (const RoutePoint& routePoint : routePoints)
     {
-        if (areSameLocation(routePoint.position, soughtPosition))
+        if (areSameLocation(*preparedPoint++, preparedSought))
         {
             std::string name = routePoint.name;
             return name.empty() ? "Unnamed Position" : name;
@@ -177,11 +186,13 @@ std::string Track::findNameOf(Position soughtPosition) const
 
 unsigned int Track::timesVisited(Position soughtPosition) const
 {
+    const PreparedPosition preparedSought(soughtPosition);
+
     unsigned int numberOfVisits = 0;
 
-    for (const RoutePoint& routePoint : routePoints)
+    for (const PreparedPosition& preparedPoint : preparedPositions)
     {
-        if (areSameLocation(routePoint.position, soughtPosition)) ++numberOfVisits;
+        if (areSameLocation(preparedPoint, preparedSought)) ++numberOfVisits;
     }
 
     return numberOfVisits;
@@ -189,11 +200,11 @@ unsigned int Track::timesVisited(Position soughtPosition) const
 
 bool Track::containsCycles() const
 {
-    for (std::list<RoutePoint>::const_iterator current = routePoints.begin(); current != routePoints.end(); ++current)
+    for (std::vector<PreparedPosition>::const_iterator current = preparedPositions.begin(); current != preparedPositions.end(); ++current)
     {
-        for (std::list<RoutePoint>::const_iterator later = std::next(current); later != routePoints.end(); ++later)
+        for (std::vector<PreparedPosition>::const_iterator later = std::next(current); later != preparedPositions.end(); ++later)
         {
-            if (areSameLocation(current->position,later->position)) return true;
+            if (areSameLocation(*current,*later)) return true;
         }
     }
     return false;
@@ -201,7 +212,12 @@ bool Track::containsCycles() const
 
 bool Track::areSameLocation(Position p1, Position p2) const
 {
-    return (Position::horizontalDistanceBetween(p1,p2) < granularity);
+    return (model->horizontalDistanceBetween(PreparedPosition(p1),PreparedPosition(p2)) < granularity);
+}
+
+bool Track::areSameLocation(const PreparedPosition& p1, const PreparedPosition& p2) const
+{
+    return (model->horizontalDistanceBetween(p1,p2) < granularity);
 }
 
 Track::TimeStamp Track::tmToTimeStamp(std::tm dateTime)
@@ -0,0 +1,96 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef GPS_HAVE_ZLIB
+  #include <zlib.h>
+#endif
+
+#include "logs.h"
+#include "parseGPX.h"
+#include "compressedInput.h"
+
+using namespace GPS;
+
+/* GPX files are read through InputFile, so a gzip compressed GPX file should give exactly the
+ * same route or track as the uncompressed file.
+ */
+
+BOOST_AUTO_TEST_SUITE( GPX_compressedFiles )
+
+#ifdef GPS_HAVE_ZLIB
+
+const std::filesystem::path tempDir = std::filesystem::temp_directory_path();
+
+// Compresses a file with gzip, returning the path of the compressed copy.
+std::filesystem::path gzipCopyOf(const std::string & source)
+{
+    std::ifstream input{source, std::ios::binary};
+    BOOST_REQUIRE_MESSAGE( input.good() , "Could not open log file: " + source );
+    std::stringstream contents;
+    contents << input.rdbuf();
+    const std::string data = contents.str();
+
+    const std::filesystem::path destination = tempDir / ("compressedGPX-tests-" + std::filesystem::path(source).filename().string() + ".gz");
+    gzFile file = gzopen(destination.string().c_str(), "wb");
+    BOOST_REQUIRE( file != nullptr );
+    BOOST_REQUIRE_EQUAL( gzwrite(file, data.data(), static_cast<unsigned>(data.size())) , static_cast<int>(data.size()) );
+    gzclose(file);
+    return destination;
+}
+
+BOOST_AUTO_TEST_CASE( gzipRoute )
+{
+    const std::string source = LogFiles::GPXRoutesDir + "NorthYorkMoors.gpx";
+    const std::filesystem::path gzipPath = gzipCopyOf(source);
+    const bool isFileName = true;
+
+    BOOST_CHECK( compressionOf(gzipPath.string()) == Compression::gzip );
+
+    const std::vector<RoutePoint> expected = GPX::parseRoute(source, isFileName);
+    const std::vector<RoutePoint> actual = GPX::parseRoute(gzipPath.string(), isFileName);
+
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].position.latitude() , expected[i].position.latitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.longitude() , expected[i].position.longitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.elevation() , expected[i].position.elevation() );
+        BOOST_CHECK_EQUAL( actual[i].name , expected[i].name );
+    }
+
+    std::filesystem::remove(gzipPath);
+}
+
+BOOST_AUTO_TEST_CASE( gzipTrack )
+{
+    const std::string source = LogFiles::GPXTracksDir + "MultipleSegments.gpx";
+    const std::filesystem::path gzipPath = gzipCopyOf(source);
+    const bool isFileName = true;
+
+    const std::vector<TrackPoint> expected = GPX::parseTrack(source, isFileName);
+    const std::vector<TrackPoint> actual = GPX::parseTrack(gzipPath.string(), isFileName);
+
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].position.latitude() , expected[i].position.latitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.longitude() , expected[i].position.longitude() );
+        BOOST_CHECK_EQUAL( actual[i].position.elevation() , expected[i].position.elevation() );
+        BOOST_CHECK_EQUAL( actual[i].name , expected[i].name );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_mday , expected[i].dateTime.tm_mday );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_hour , expected[i].dateTime.tm_hour );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_min , expected[i].dateTime.tm_min );
+        BOOST_CHECK_EQUAL( actual[i].dateTime.tm_sec , expected[i].dateTime.tm_sec );
+    }
+
+    std::filesystem::remove(gzipPath);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,5 +6,6 @@
  * The test suites themselves can be found in:
  *    tests/gpx/parseRoute-tests.cpp
  *    tests/gpx/parseTrack-tests.cpp
+ *    tests/gpx/compressedGPX-tests.cpp
  *    tests/xml/parser-tests.cpp
  */
@@ -0,0 +1,115 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "logs.h"
+#include "byteScan.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* The SIMD kernels must produce exactly the same results as the scalar kernels.
+ * The main risks are in the handling of the partial block at the end of a buffer,
+ * and of delimiters at each position within a block, so the kernels are compared
+ * over every starting offset of every NMEA log file.
+ */
+
+BOOST_AUTO_TEST_SUITE( ByteScanKernels )
+
+std::vector<std::string> allNMEALogs()
+{
+    std::vector<std::string> contents;
+    for (const std::filesystem::directory_entry & entry : std::filesystem::directory_iterator(LogFiles::NMEALogsDir))
+    {
+        std::ifstream log{entry.path()};
+        std::stringstream buffer;
+        buffer << log.rdbuf();
+        contents.push_back(buffer.str());
+    }
+    BOOST_REQUIRE_MESSAGE( ! contents.empty() , "No log files found in: " + LogFiles::NMEALogsDir );
+    return contents;
+}
+
+BOOST_AUTO_TEST_CASE( ScalarKernelsAvailable )
+{
+    const std::vector<const ByteScan::Kernels *> kernels = ByteScan::availableKernels();
+
+    BOOST_REQUIRE( ! kernels.empty() );
+    BOOST_CHECK_EQUAL( kernels.front() , &ByteScan::scalarKernels() );
+    BOOST_CHECK_EQUAL( kernels.back() , &ByteScan::bestKernels() );
+}
+
+BOOST_AUTO_TEST_CASE( EmptyBuffer )
+{
+    for (const ByteScan::Kernels * kernels : ByteScan::availableKernels())
+    {
+        BOOST_CHECK_EQUAL( kernels->xorReduce("", 0) , 0 );
+        BOOST_CHECK_EQUAL( kernels->findDelimiter("", 0) , 0u );
+
+        unsigned char total = 0x5A;
+        BOOST_CHECK_EQUAL( kernels->findDelimiterXor("", 0, total) , 0u );
+        BOOST_CHECK_EQUAL( total , 0x5A );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( EveryDelimiterPosition )
+{
+    for (const char delimiter : {',', '*', '$', '\n'})
+    {
+        for (std::size_t position = 0; position < 100; ++position)
+        {
+            std::string buffer(100, 'A');
+            buffer[position] = delimiter;
+            for (const ByteScan::Kernels * kernels : ByteScan::availableKernels())
+            {
+                BOOST_CHECK_EQUAL( kernels->findDelimiter(buffer.data(), buffer.size()) , position );
+
+                unsigned char total = 0;
+                BOOST_CHECK_EQUAL( kernels->findDelimiterXor(buffer.data(), buffer.size(), total) , position );
+                BOOST_CHECK_EQUAL( total , (position % 2 == 0) ? 0 : 'A' );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( MatchesScalarOnLogFiles )
+{
+    const ByteScan::Kernels & scalar = ByteScan::scalarKernels();
+
+    for (const std::string & log : allNMEALogs())
+    {
+        for (const ByteScan::Kernels * kernels : ByteScan::availableKernels())
+        {
+            BOOST_TEST_CONTEXT( kernels->name )
+            {
+                // The whole file, at every alignment within a 32 byte block.
+                for (std::size_t start = 0; start < 32 && start < log.size(); ++start)
+                {
+                    BOOST_CHECK_EQUAL( kernels->xorReduce(log.data() + start, log.size() - start) ,
+                                       scalar.xorReduce(log.data() + start, log.size() - start) );
+                }
+
+                // The next delimiter, and the bytes up to it, from every offset.
+                for (std::size_t start = 0; start < log.size(); ++start)
+                {
+                    const std::size_t expected = scalar.findDelimiter(log.data() + start, log.size() - start);
+                    const std::size_t actual = kernels->findDelimiter(log.data() + start, log.size() - start);
+                    BOOST_REQUIRE_EQUAL( actual , expected );
+
+                    BOOST_CHECK_EQUAL( kernels->xorReduce(log.data() + start, actual) ,
+                                       scalar.xorReduce(log.data() + start, expected) );
+
+                    unsigned char total = 0;
+                    BOOST_CHECK_EQUAL( kernels->findDelimiterXor(log.data() + start, log.size() - start, total) , expected );
+                    BOOST_CHECK_EQUAL( total , scalar.xorReduce(log.data() + start, expected) );
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
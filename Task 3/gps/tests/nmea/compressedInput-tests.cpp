@@ -0,0 +1,258 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef GPS_HAVE_ZLIB
+  #include <zlib.h>
+#endif
+
+#ifdef GPS_HAVE_ZSTD
+  #include <zstd.h>
+#endif
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "compressedInput.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( CompressedInputTests )
+
+const std::filesystem::path tempDir = std::filesystem::temp_directory_path();
+
+std::string contentsOf(const std::string & filePath)
+{
+    std::ifstream file{filePath, std::ios::binary};
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+void checkSamePositions(const std::vector<Position> & actual, const std::vector<Position> & expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].latitude() , expected[i].latitude() );
+        BOOST_CHECK_EQUAL( actual[i].longitude() , expected[i].longitude() );
+        BOOST_CHECK_EQUAL( actual[i].elevation() , expected[i].elevation() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( DetectsMagicBytes )
+{
+    BOOST_CHECK( detectCompression("\x1F\x8B\x08\x00") == Compression::gzip );
+    BOOST_CHECK( detectCompression("\x28\xB5\x2F\xFD") == Compression::zstd );
+    BOOST_CHECK( detectCompression("\x28\xB5\x2F") == Compression::none );
+    BOOST_CHECK( detectCompression("$GPGLL") == Compression::none );
+    BOOST_CHECK( detectCompression("") == Compression::none );
+
+    BOOST_CHECK( compressionOf(LogFiles::NMEALogsDir + "gll.log") == Compression::none );
+    BOOST_CHECK( canDecompress(Compression::none) );
+}
+
+BOOST_AUTO_TEST_CASE( Uncompressed )
+{
+    const std::string filePath = LogFiles::NMEALogsDir + "gga_rmc-1.log";
+    InputFile file(filePath);
+    BOOST_CHECK( file.compression() == Compression::none );
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    BOOST_CHECK( buffer.str() == contentsOf(filePath) );
+    BOOST_CHECK_NO_THROW( file.checkDecompression() );
+
+    BOOST_CHECK_THROW( InputFile(LogFiles::NMEALogsDir + "nonexistent.log") , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( UnsupportedFormat )
+{
+    if (canDecompress(Compression::zstd)) return;
+
+    const std::filesystem::path filePath = tempDir / "compressedInput-tests.log.zst";
+    {
+        std::ofstream file{filePath, std::ios::binary};
+        file << "\x28\xB5\x2F\xFD" << "not really zstd";
+    }
+    BOOST_CHECK_THROW( InputFile{filePath.string()} , std::domain_error );
+    BOOST_CHECK_THROW( positionsFromLog(filePath.string()) , std::domain_error );
+    std::filesystem::remove(filePath);
+}
+
+#ifdef GPS_HAVE_ZLIB
+
+void gzipFile(const std::string & source, const std::filesystem::path & destination, const char * mode = "wb")
+{
+    const std::string contents = contentsOf(source);
+    gzFile file = gzopen(destination.string().c_str(), mode);
+    BOOST_REQUIRE( file != nullptr );
+    BOOST_REQUIRE_EQUAL( gzwrite(file, contents.data(), static_cast<unsigned>(contents.size())) , static_cast<int>(contents.size()) );
+    gzclose(file);
+}
+
+BOOST_AUTO_TEST_CASE( GzipLogs )
+{
+    BOOST_REQUIRE( canDecompress(Compression::gzip) );
+
+    for (const std::string filename : { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" })
+    {
+        const std::string logPath = LogFiles::NMEALogsDir + filename;
+        const std::filesystem::path gzipPath = tempDir / ("compressedInput-tests-" + filename + ".gz");
+        gzipFile(logPath, gzipPath);
+
+        BOOST_CHECK( compressionOf(gzipPath.string()) == Compression::gzip );
+
+        const std::vector<Position> expected = positionsFromLog(logPath);
+        checkSamePositions(positionsFromLog(gzipPath.string()), expected);
+
+        PositionBatch batch(true);
+        positionsFromLogInto(gzipPath.string(), batch);
+        BOOST_CHECK_EQUAL( batch.size() , expected.size() );
+
+        if (filename != "gll.log")
+        {
+            BOOST_CHECK_EQUAL( trackPointsFromLog(gzipPath.string()).size() , trackPointsFromLog(logPath).size() );
+        }
+
+        std::filesystem::remove(gzipPath);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( LargerThanPipeline )
+{
+    // Enough data to fill the decompression thread's queue several times over.
+    const std::filesystem::path largeLog = tempDir / "compressedInput-tests-large.log";
+    {
+        std::ofstream output{largeLog, std::ios::binary};
+        for (int repeat = 0; repeat < 40; ++repeat) output << contentsOf(LogFiles::NMEALogsDir + "gga_rmc-1.log");
+    }
+    const std::filesystem::path gzipPath = tempDir / "compressedInput-tests-large.log.gz";
+    gzipFile(largeLog.string(), gzipPath);
+
+    {
+        InputFile file(gzipPath.string());
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        BOOST_CHECK( buffer.str() == contentsOf(largeLog.string()) );
+        BOOST_CHECK_NO_THROW( file.checkDecompression() );
+    }
+
+    // Abandoning the stream part of the way through stops the decompression thread.
+    {
+        InputFile file(gzipPath.string());
+        std::string line;
+        BOOST_CHECK( std::getline(file, line) );
+    }
+
+    std::filesystem::remove(gzipPath);
+    std::filesystem::remove(largeLog);
+}
+
+BOOST_AUTO_TEST_CASE( ConcatenatedMembers )
+{
+    const std::filesystem::path gzipPath = tempDir / "compressedInput-tests-concatenated.log.gz";
+    gzipFile(LogFiles::NMEALogsDir + "gll.log", gzipPath);
+    gzipFile(LogFiles::NMEALogsDir + "gga_rmc-1.log", gzipPath, "ab");
+
+    std::vector<Position> expected = positionsFromLog(LogFiles::NMEALogsDir + "gll.log");
+    const std::vector<Position> second = positionsFromLog(LogFiles::NMEALogsDir + "gga_rmc-1.log");
+    expected.insert(expected.end(), second.begin(), second.end());
+
+    checkSamePositions(positionsFromLog(gzipPath.string()), expected);
+    std::filesystem::remove(gzipPath);
+}
+
+BOOST_AUTO_TEST_CASE( TruncatedOrCorrupt )
+{
+    const std::filesystem::path gzipPath = tempDir / "compressedInput-tests-truncated.log.gz";
+    gzipFile(LogFiles::NMEALogsDir + "gga_rmc-1.log", gzipPath);
+    std::filesystem::resize_file(gzipPath, std::filesystem::file_size(gzipPath) / 2);
+    BOOST_CHECK_THROW( positionsFromLog(gzipPath.string()) , std::domain_error );
+
+    {
+        std::ofstream file{gzipPath, std::ios::binary};
+        file << "\x1F\x8B" << "not really gzip";
+    }
+    BOOST_CHECK_THROW( positionsFromLog(gzipPath.string()) , std::domain_error );
+    std::filesystem::remove(gzipPath);
+}
+
+#endif
+
+#ifdef GPS_HAVE_ZSTD
+
+// Compresses some data as a single zstd frame, appended to the file if 'append' is set.
+void zstdFile(const std::string & contents, const std::filesystem::path & destination, bool append = false)
+{
+    std::string compressed(ZSTD_compressBound(contents.size()), '\0');
+    const std::size_t size = ZSTD_compress(compressed.data(), compressed.size(), contents.data(), contents.size(), 3);
+    BOOST_REQUIRE( ! ZSTD_isError(size) );
+
+    std::ofstream file{destination, std::ios::binary | (append ? std::ios::app : std::ios::trunc)};
+    file.write(compressed.data(), static_cast<std::streamsize>(size));
+}
+
+BOOST_AUTO_TEST_CASE( ZstdLogs )
+{
+    BOOST_REQUIRE( canDecompress(Compression::zstd) );
+
+    for (const std::string filename : { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" })
+    {
+        const std::string logPath = LogFiles::NMEALogsDir + filename;
+        const std::filesystem::path zstdPath = tempDir / ("compressedInput-tests-" + filename + ".zst");
+        zstdFile(contentsOf(logPath), zstdPath);
+
+        BOOST_CHECK( compressionOf(zstdPath.string()) == Compression::zstd );
+
+        {
+            InputFile file(zstdPath.string());
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            BOOST_CHECK( buffer.str() == contentsOf(logPath) );
+            BOOST_CHECK_NO_THROW( file.checkDecompression() );
+        }
+
+        checkSamePositions(positionsFromLog(zstdPath.string()), positionsFromLog(logPath));
+        std::filesystem::remove(zstdPath);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( ZstdConcatenatedFrames )
+{
+    BOOST_REQUIRE( canDecompress(Compression::zstd) );
+
+    const std::filesystem::path zstdPath = tempDir / "compressedInput-tests-concatenated.log.zst";
+    zstdFile(contentsOf(LogFiles::NMEALogsDir + "gll.log"), zstdPath);
+    zstdFile(contentsOf(LogFiles::NMEALogsDir + "gga_rmc-1.log"), zstdPath, true);
+
+    std::vector<Position> expected = positionsFromLog(LogFiles::NMEALogsDir + "gll.log");
+    const std::vector<Position> second = positionsFromLog(LogFiles::NMEALogsDir + "gga_rmc-1.log");
+    expected.insert(expected.end(), second.begin(), second.end());
+
+    checkSamePositions(positionsFromLog(zstdPath.string()), expected);
+    std::filesystem::remove(zstdPath);
+}
+
+BOOST_AUTO_TEST_CASE( ZstdEmptyOrTruncated )
+{
+    BOOST_REQUIRE( canDecompress(Compression::zstd) );
+
+    const std::filesystem::path zstdPath = tempDir / "compressedInput-tests-truncated.log.zst";
+    zstdFile("", zstdPath);
+    BOOST_CHECK( positionsFromLog(zstdPath.string()).empty() );
+
+    zstdFile(contentsOf(LogFiles::NMEALogsDir + "gga_rmc-1.log"), zstdPath);
+    std::filesystem::resize_file(zstdPath, std::filesystem::file_size(zstdPath) / 2);
+    BOOST_CHECK_THROW( positionsFromLog(zstdPath.string()) , std::domain_error );
+    std::filesystem::remove(zstdPath);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
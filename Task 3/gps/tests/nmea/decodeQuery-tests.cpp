@@ -0,0 +1,229 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "decodeQuery.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( DecodeQueryTests )
+
+const std::vector<std::string> logFilenames = { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" };
+
+std::string contentsOf(const std::string & filename)
+{
+    std::ifstream log{LogFiles::NMEALogsDir + filename};
+    std::stringstream buffer;
+    buffer << log.rdbuf();
+    return buffer.str();
+}
+
+std::string withChecksum(const std::string & body)
+{
+    unsigned char checksum = 0;
+    for (char c : body) checksum ^= static_cast<unsigned char>(c);
+    char hex[3];
+    std::snprintf(hex, sizeof(hex), "%02X", checksum);
+    return "$" + body + "*" + hex;
+}
+
+// The positions of a log, with time stamps, that satisfy a predicate.
+template <typename Predicate>
+PositionBatch expectedPositions(const std::string & log, Predicate accept)
+{
+    PositionBatch all(true, true);
+    positionsFromBufferInto(log, all);
+
+    PositionBatch expected(true, true);
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+        if (accept(all[i], all.timeStamps()[i])) expected.push_back(all[i], all.timeStamps()[i], all.fixQualities()[i]);
+    }
+    return expected;
+}
+
+void checkSamePositions(const PositionBatch & actual, const PositionBatch & expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    BOOST_CHECK( actual.latitudes() == expected.latitudes() );
+    BOOST_CHECK( actual.longitudes() == expected.longitudes() );
+    BOOST_CHECK( actual.elevations() == expected.elevations() );
+}
+
+BOOST_AUTO_TEST_CASE( DefaultQueryAcceptsEverything )
+{
+    for (const std::string & filename : logFilenames)
+    {
+        const std::string log = contentsOf(filename);
+
+        PositionBatch actual;
+        positionsFromBufferInto(log, actual, DecodeQuery());
+        checkSamePositions(actual, expectedPositions(log, [](const Position &, double) { return true; }));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( ElevationProjection )
+{
+    DecodeQuery query;
+    query.elevations = false;
+
+    const std::string log = contentsOf("gga_rmc-1.log");
+    const std::vector<Position> all = positionsFromBuffer(log);
+    const std::vector<Position> projected = positionsFromBuffer(log, query);
+
+    BOOST_REQUIRE_EQUAL( projected.size() , all.size() );
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( projected[i].latitude() , all[i].latitude() );
+        BOOST_CHECK_EQUAL( projected[i].longitude() , all[i].longitude() );
+        BOOST_CHECK_EQUAL( projected[i].elevation() , 0 );
+    }
+
+    // The elevation field is not even validated.
+    const std::string badElevation = withChecksum("GPGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,xx,M,,M,,");
+    SentenceView sentence;
+    BOOST_REQUIRE( scanSentence(badElevation, sentence) == SentenceStatus::ok );
+    BOOST_CHECK( ! tryInterpretSentenceData(sentence) );
+    BOOST_CHECK( tryInterpretSentenceData(sentence, query) );
+}
+
+BOOST_AUTO_TEST_CASE( BoundingBox )
+{
+    DecodeQuery query;
+    query.minLatitude = 37.375;
+    query.maxLatitude = 37.4;
+    query.minLongitude = -6.0;
+    query.maxLongitude = -5.99;
+
+    const std::string log = contentsOf("gga_rmc-1.log");
+    const PositionBatch expected = expectedPositions(log, [&](const Position & position, double)
+    {
+        return position.latitude() >= query.minLatitude && position.latitude() <= query.maxLatitude
+            && position.longitude() >= query.minLongitude && position.longitude() <= query.maxLongitude;
+    });
+    BOOST_REQUIRE( ! expected.empty() );
+
+    IngestStats stats;
+    PositionBatch actual;
+    positionsFromBufferInto(log, actual, query, TalkerSet::gps(), nullptr, &stats);
+    checkSamePositions(actual, expected);
+    BOOST_CHECK_EQUAL( stats.accepted() , expected.size() );
+    BOOST_CHECK_EQUAL( stats.filtered , positionsFromBuffer(log).size() - expected.size() );
+    BOOST_CHECK_EQUAL( stats.invalidFields , 0u );
+}
+
+BOOST_AUTO_TEST_CASE( BoundingBoxAcrossAntiMeridian )
+{
+    DecodeQuery query;
+    query.minLongitude = 170;
+    query.maxLongitude = -170;
+
+    BOOST_CHECK( query.acceptsLongitude(175) );
+    BOOST_CHECK( query.acceptsLongitude(-175) );
+    BOOST_CHECK( query.acceptsLongitude(180) );
+    BOOST_CHECK( ! query.acceptsLongitude(0) );
+    BOOST_CHECK( ! query.acceptsLongitude(-5.99) );
+}
+
+BOOST_AUTO_TEST_CASE( TimeRange )
+{
+    DecodeQuery query;
+    query.earliestTime = 10 * 3600;
+    query.latestTime = 11 * 3600;
+
+    for (const std::string filename : { "gga_rmc-1.log", "gga_rmc-2.log" })
+    {
+        const std::string log = contentsOf(filename);
+        const PositionBatch expected = expectedPositions(log, [&](const Position &, double time)
+        {
+            return time >= query.earliestTime && time <= query.latestTime;
+        });
+
+        PositionBatch actual(true);
+        positionsFromBufferInto(log, actual, query);
+        checkSamePositions(actual, expected);
+        for (double time : actual.timeStamps()) BOOST_CHECK( query.acceptsTime(time) );
+    }
+
+    BOOST_CHECK( ! query.acceptsTime(PositionBatch::unknownTimeStamp) );
+    BOOST_CHECK( ! DecodeQuery().restrictsTime() );
+}
+
+BOOST_AUTO_TEST_CASE( MinimumFixQuality )
+{
+    const std::string noFix = withChecksum("GPGGA,094627.000,3723.1622,N,00559.5788,W,0,0,,30.0,M,,M,,");
+    const std::string gpsFix = withChecksum("GPGGA,094628.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,");
+    const std::string dgpsFix = withChecksum("GPGGA,094629.000,3723.1622,N,00559.5788,W,2,0,,30.0,M,,M,,");
+    const std::string voidRMC = withChecksum("GPRMC,094630.000,V,3723.1622,N,00559.5788,W,0.000,0.00,150914,,A");
+    const std::string gll = "$GPGLL,5425.32,N,107.11,W,82319*65"; // no status field
+    const std::string log = noFix + "\n" + gpsFix + "\n" + dgpsFix + "\n" + voidRMC + "\n" + gll + "\n";
+
+    DecodeQuery query;
+    BOOST_CHECK_EQUAL( positionsFromBuffer(log, query).size() , 5u );
+
+    query.minFixQuality = 1;
+    IngestStats stats;
+    BOOST_CHECK_EQUAL( positionsFromBuffer(log, query, TalkerSet::gps(), nullptr, &stats).size() , 2u );
+    BOOST_CHECK_EQUAL( stats.filtered , 3u );
+
+    query.minFixQuality = 2;
+    BOOST_CHECK_EQUAL( positionsFromBuffer(log, query).size() , 1u );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidSentencesStillRejected )
+{
+    DecodeQuery query;
+    query.minLatitude = 0;
+
+    IngestStats stats;
+    positionsFromBuffer("$GPGLL,5425.32,N,107.11,X,82319*6A\n", query, TalkerSet::gps(), nullptr, &stats);
+    BOOST_CHECK_EQUAL( stats.invalidFields , 1u );
+    BOOST_CHECK_EQUAL( stats.filtered , 0u );
+
+    // The latitude is outside the box, but the invalid longitude still takes precedence.
+    query.minLatitude = -90;
+    query.maxLatitude = 50;
+    IngestStats outsideStats;
+    positionsFromBuffer(withChecksum("GPGLL,5425.32,N,107.11,X,82319") + "\n", query, TalkerSet::gps(), nullptr, &outsideStats);
+    BOOST_CHECK_EQUAL( outsideStats.invalidFields , 1u );
+    BOOST_CHECK_EQUAL( outsideStats.filtered , 0u );
+}
+
+BOOST_AUTO_TEST_CASE( FromLogFiles )
+{
+    DecodeQuery query;
+    query.maxLatitude = 50;
+    query.elevations = false;
+
+    for (const std::string & filename : logFilenames)
+    {
+        const std::string filePath = LogFiles::NMEALogsDir + filename;
+
+        std::ifstream log{filePath};
+        const std::vector<Position> expected = positionsFromLog(log, query);
+
+        for (unsigned int numThreads : { 1u, 4u })
+        {
+            const std::vector<Position> actual = positionsFromLog(filePath, query, TalkerSet::gps(), nullptr, numThreads);
+            BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+            for (std::size_t i = 0; i < expected.size(); ++i)
+            {
+                BOOST_CHECK_EQUAL( actual[i].latitude() , expected[i].latitude() );
+            }
+        }
+
+        PositionBatch batch;
+        positionsFromLogInto(filePath, batch, query);
+        BOOST_CHECK_EQUAL( batch.size() , expected.size() );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "epochFusion.h"
+#include "streamDecoder.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( EpochFusionTests )
+
+const double percentageTolerance = 0.0001;
+
+std::vector<Fix> fixesFromFile(const std::string & filename)
+{
+    std::ifstream log{LogFiles::NMEALogsDir + filename};
+    return fixesFromLog(log);
+}
+
+BOOST_AUTO_TEST_CASE( MergesEpochs )
+{
+    std::stringstream log;
+    log << "$GPRMC,094627.000,A,3723.1622,N,00559.5788,W,12.5,271.3,150914,,A*6E\n"
+        << "$GPGGA,094627.000,3723.1622,N,00559.5788,W,2,0,,30.0,M,,M,,*79\n"
+        << "$GPGGA,094628.000,3723.1622,N,00559.5788,W,1,0,,31.0,M,,M,,*74\n";
+
+    const std::vector<Fix> fixes = fixesFromLog(log);
+
+    BOOST_REQUIRE_EQUAL( fixes.size() , 2u );
+
+    // Elevation and fix quality from the GGA, even though the RMC came first.
+    BOOST_CHECK( fixes[0].hasElevation );
+    BOOST_CHECK_CLOSE( fixes[0].position.elevation() , 30.0 , percentageTolerance );
+    BOOST_CHECK_EQUAL( fixes[0].fixQuality , 2 );
+    BOOST_CHECK_EQUAL( fixes[0].timeOfDay , 9*3600 + 46*60 + 27 );
+
+    // Date, speed and course from the RMC.
+    BOOST_REQUIRE( fixes[0].date );
+    BOOST_CHECK_EQUAL( fixes[0].date->tm_mday , 15 );
+    BOOST_REQUIRE( fixes[0].groundSpeed );
+    BOOST_CHECK_CLOSE( *fixes[0].groundSpeed , 12.5 * 1852 / 3600 , percentageTolerance );
+    BOOST_REQUIRE( fixes[0].course );
+    BOOST_CHECK_CLOSE( *fixes[0].course , 271.3 , percentageTolerance );
+
+    // The second epoch only has a GGA sentence.
+    BOOST_CHECK_CLOSE( fixes[1].position.elevation() , 31.0 , percentageTolerance );
+    BOOST_CHECK( ! fixes[1].date );
+    BOOST_CHECK( ! fixes[1].groundSpeed );
+}
+
+BOOST_AUTO_TEST_CASE( HalvesGGARMCLogs )
+{
+    for (const std::string filename : { "gga_rmc-1.log", "gga_rmc-2.log" })
+    {
+        std::ifstream log{LogFiles::NMEALogsDir + filename};
+        const std::vector<Position> positions = positionsFromLog(log);
+        const std::vector<Fix> fixes = fixesFromFile(filename);
+
+        BOOST_CHECK_EQUAL( fixes.size() * 2 , positions.size() );
+        for (const Fix & fix : fixes)
+        {
+            BOOST_CHECK( fix.hasElevation );
+            BOOST_CHECK( fix.date );
+            BOOST_CHECK( fix.groundSpeed );
+            BOOST_CHECK( fix.course );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( DistinctTimesNotMerged )
+{
+    std::ifstream log{LogFiles::NMEALogsDir + "gll.log"};
+    const std::vector<Position> positions = positionsFromLog(log);
+    const std::vector<Fix> fixes = fixesFromFile("gll.log");
+
+    BOOST_REQUIRE_EQUAL( fixes.size() , positions.size() );
+    for (std::size_t i = 0; i < fixes.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( fixes[i].position.latitude() , positions[i].latitude() );
+        BOOST_CHECK( ! fixes[i].hasElevation );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( StreamDecoderMatches )
+{
+    std::ifstream log{LogFiles::NMEALogsDir + "gga_rmc-2.log"};
+    std::stringstream buffer;
+    buffer << log.rdbuf();
+    const std::string contents = buffer.str();
+
+    std::vector<Fix> streamed;
+    StreamDecoder decoder = StreamDecoder::fusingEpochs([&streamed](const Fix & fix) { streamed.push_back(fix); });
+
+    // Small chunks that split many sentences.
+    const std::size_t chunkSize = 7;
+    for (std::size_t pos = 0; pos < contents.size(); pos += chunkSize)
+    {
+        decoder.feed(contents.data() + pos, std::min(chunkSize, contents.size() - pos));
+    }
+    decoder.finish();
+
+    const std::vector<Fix> fixes = fixesFromFile("gga_rmc-2.log");
+    BOOST_REQUIRE_EQUAL( streamed.size() , fixes.size() );
+    for (std::size_t i = 0; i < fixes.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( streamed[i].timeOfDay , fixes[i].timeOfDay );
+        BOOST_CHECK_EQUAL( streamed[i].position.elevation() , fixes[i].position.elevation() );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
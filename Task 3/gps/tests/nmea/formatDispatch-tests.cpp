@@ -0,0 +1,34 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "parseNMEA.h"
+
+using namespace NMEA;
+
+/* Sentence formats are looked up in a perfect hash table, so every other three-letter
+ * code must be rejected, including those that share a slot with a supported format.
+ */
+
+BOOST_AUTO_TEST_SUITE( FormatDispatch )
+
+BOOST_AUTO_TEST_CASE( EveryThreeLetterCode )
+{
+    unsigned int numSupported = 0;
+    std::string format = "AAA";
+    for (format[0] = 'A'; format[0] <= 'Z'; ++format[0])
+    {
+        for (format[1] = 'A'; format[1] <= 'Z'; ++format[1])
+        {
+            for (format[2] = 'A'; format[2] <= 'Z'; ++format[2])
+            {
+                const bool expected = (format == "GLL" || format == "GGA" || format == "RMC");
+                BOOST_CHECK_EQUAL( isSupportedSentenceFormat(format) , expected );
+                if (isSupportedSentenceFormat(format)) ++numSupported;
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL( numSupported , 3u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "ingestStats.h"
+#include "streamDecoder.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( IngestStatsTests )
+
+const std::vector<std::string> logFilenames = { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" };
+
+void checkSameCounts(const IngestStats & actual, const IngestStats & expected)
+{
+    BOOST_CHECK_EQUAL( actual.linesRead , expected.linesRead );
+    BOOST_CHECK_EQUAL( actual.bytesRead , expected.bytesRead );
+    BOOST_CHECK_EQUAL( actual.malformed , expected.malformed );
+    BOOST_CHECK_EQUAL( actual.badChecksum , expected.badChecksum );
+    BOOST_CHECK_EQUAL( actual.unsupportedFormat , expected.unsupportedFormat );
+    BOOST_CHECK_EQUAL( actual.invalidFields , expected.invalidFields );
+    for (const std::string format : { "GLL", "GGA", "RMC" })
+    {
+        BOOST_CHECK_EQUAL( actual.accepted(format) , expected.accepted(format) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( RejectionReasons )
+{
+    const std::string log =
+        "$GPGLL,5425.32,N,107.11,W,82319*65\n"   // accepted
+        "not a sentence\n"                       // malformed
+        "\n"                                     // malformed
+        "$GPGLL,5425.32,N,107.11,W,82319*66\n"   // bad checksum
+        "$GPZDA,082319,01,01,2020,,*49\n"        // unsupported format
+        "$GPGLL,5425.32,N,107.11,X,82319*6A\n"   // invalid field
+        "$GPGLL,5425.32,N,107.11,W,82319*65";    // accepted, with no final line break
+
+    IngestStats stats;
+    std::stringstream stream{log};
+    const std::vector<Position> positions = positionsFromLog(stream, TalkerSet::gps(), nullptr, &stats);
+
+    BOOST_CHECK_EQUAL( positions.size() , 2u );
+    BOOST_CHECK_EQUAL( stats.linesRead , 7u );
+    BOOST_CHECK_EQUAL( stats.bytesRead , log.size() );
+    BOOST_CHECK_EQUAL( stats.accepted() , 2u );
+    BOOST_CHECK_EQUAL( stats.accepted("GLL") , 2u );
+    BOOST_CHECK_EQUAL( stats.accepted("GGA") , 0u );
+    BOOST_CHECK_EQUAL( stats.malformed , 2u );
+    BOOST_CHECK_EQUAL( stats.badChecksum , 1u );
+    BOOST_CHECK_EQUAL( stats.unsupportedFormat , 1u );
+    BOOST_CHECK_EQUAL( stats.invalidFields , 1u );
+    BOOST_CHECK_EQUAL( stats.rejected() , 5u );
+
+    // The buffer version gives the same counts.
+    IngestStats bufferStats;
+    positionsFromBuffer(log, TalkerSet::gps(), nullptr, &bufferStats);
+    checkSameCounts(bufferStats, stats);
+}
+
+BOOST_AUTO_TEST_CASE( LogFile )
+{
+    const std::string filePath = LogFiles::NMEALogsDir + "gga_rmc-1.log";
+
+    IngestStats stats;
+    const std::vector<Position> positions = positionsFromLog(filePath, TalkerSet::gps(), nullptr, 1, &stats);
+
+    BOOST_CHECK_EQUAL( stats.linesRead , 634u );
+    BOOST_CHECK_EQUAL( stats.bytesRead , std::filesystem::file_size(filePath) );
+    BOOST_CHECK_EQUAL( stats.accepted("GGA") , 316u );
+    BOOST_CHECK_EQUAL( stats.accepted("RMC") , 316u );
+    BOOST_CHECK_EQUAL( stats.accepted() , positions.size() );
+    BOOST_CHECK_EQUAL( stats.malformed , 2u ); // the header line and a blank line
+    BOOST_CHECK( stats.elapsed.count() > 0 );
+    BOOST_CHECK( stats.linesPerSecond() > 0 );
+    BOOST_CHECK( stats.bytesPerSecond() > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( Accumulates )
+{
+    IngestStats total;
+    IngestStats expected;
+    for (const std::string & filename : logFilenames)
+    {
+        IngestStats fileStats;
+        positionsFromLog(LogFiles::NMEALogsDir + filename, TalkerSet::gps(), nullptr, 1, &fileStats);
+        expected += fileStats;
+
+        positionsFromLog(LogFiles::NMEALogsDir + filename, TalkerSet::gps(), nullptr, 1, &total);
+    }
+    checkSameCounts(total, expected);
+    BOOST_CHECK_EQUAL( total.accepted() , expected.accepted("GLL") + expected.accepted("GGA") + expected.accepted("RMC") );
+}
+
+BOOST_AUTO_TEST_CASE( ParallelMatchesSequential )
+{
+    const std::filesystem::path largeLog = std::filesystem::temp_directory_path() / "ingestStats-tests.log";
+    {
+        std::ofstream output{largeLog};
+        for (int repeat = 0; repeat < 10; ++repeat)
+        {
+            for (const std::string & filename : logFilenames)
+            {
+                output << std::ifstream{LogFiles::NMEALogsDir + filename}.rdbuf();
+            }
+        }
+    }
+
+    IngestStats sequential;
+    IngestStats parallel;
+    positionsFromLog(largeLog.string(), TalkerSet::gps(), nullptr, 1, &sequential);
+    positionsFromLog(largeLog.string(), TalkerSet::gps(), nullptr, 4, &parallel);
+    std::filesystem::remove(largeLog);
+
+    checkSameCounts(parallel, sequential);
+}
+
+BOOST_AUTO_TEST_CASE( StreamDecoderMatches )
+{
+    for (const std::string & filename : logFilenames)
+    {
+        std::ifstream log{LogFiles::NMEALogsDir + filename};
+        std::stringstream buffer;
+        buffer << log.rdbuf();
+        const std::string contents = buffer.str();
+
+        IngestStats expected;
+        positionsFromBuffer(contents, TalkerSet::gps(), nullptr, &expected);
+
+        StreamDecoder decoder([](const Position &) {});
+        const std::size_t chunkSize = 100;
+        for (std::size_t pos = 0; pos < contents.size(); pos += chunkSize)
+        {
+            decoder.feed(contents.data() + pos, std::min(chunkSize, contents.size() - pos));
+        }
+        decoder.finish();
+
+        checkSameCounts(decoder.ingestStats(), expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( StreamDecoderOverlongLines )
+{
+    StreamDecoder decoder([](const Position &) {});
+    const std::string overlong(StreamDecoder::maxLineLength + 1, 'x');
+    decoder.feed(overlong.data(), overlong.size());
+    decoder.feed("\n", 1);
+    decoder.feed(overlong.data(), overlong.size());
+    decoder.finish();
+
+    BOOST_CHECK_EQUAL( decoder.ingestStats().linesRead , 2u );
+    BOOST_CHECK_EQUAL( decoder.ingestStats().malformed , 2u );
+    BOOST_CHECK_EQUAL( decoder.ingestStats().bytesRead , 2 * overlong.size() + 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "multiLog.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( MultiLogTests )
+
+const std::vector<std::string> logFilenames = { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" };
+
+std::vector<std::string> logPaths()
+{
+    std::vector<std::string> paths;
+    for (const std::string & filename : logFilenames) paths.push_back(LogFiles::NMEALogsDir + filename);
+    return paths;
+}
+
+// A GLL sentence at the given time, with the latitude identifying it.
+std::string gllSentence(const std::string & time, int latitudeMinutes)
+{
+    const std::string body = "GPGLL,54" + std::to_string(latitudeMinutes) + ".00,N,107.11,W," + time;
+    unsigned char checksum = 0;
+    for (char c : body) checksum ^= static_cast<unsigned char>(c);
+    char hex[3];
+    std::snprintf(hex, sizeof(hex), "%02X", checksum);
+    return "$" + body + "*" + hex + "\n";
+}
+
+std::string writeLog(const std::string & filename, const std::vector<std::string> & sentences)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / filename;
+    std::ofstream log{path};
+    for (const std::string & sentence : sentences) log << sentence;
+    return path.string();
+}
+
+BOOST_AUTO_TEST_CASE( PerFileResults )
+{
+    const std::vector<std::string> paths = logPaths();
+    for (unsigned int numThreads : { 1u, 2u, 8u })
+    {
+        const std::vector<LogPositions> results = positionsFromLogs(paths, numThreads);
+        BOOST_REQUIRE_EQUAL( results.size() , paths.size() );
+        for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL( results[i].filePath , paths[i] );
+
+            PositionBatch expected(true, true);
+            positionsFromLogInto(paths[i], expected);
+            BOOST_REQUIRE_EQUAL( results[i].positions.size() , expected.size() );
+            BOOST_CHECK( results[i].positions.latitudes() == expected.latitudes() );
+            BOOST_CHECK( results[i].positions.fixQualities() == expected.fixQualities() );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( Stats )
+{
+    IngestStats expected;
+    for (const std::string & path : logPaths()) positionsFromLog(path, TalkerSet::gps(), nullptr, 1, &expected);
+
+    IngestStats stats;
+    TalkerCounts talkerCounts;
+    positionsFromLogs(logPaths(), TalkerSet::gps(), &talkerCounts, 2, &stats);
+
+    BOOST_CHECK_EQUAL( stats.linesRead , expected.linesRead );
+    BOOST_CHECK_EQUAL( stats.accepted() , expected.accepted() );
+    BOOST_CHECK_EQUAL( stats.malformed , expected.malformed );
+    BOOST_CHECK( stats.elapsed.count() > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( MergedLogFiles )
+{
+    const std::vector<std::string> paths = logPaths();
+    const PositionBatch merged = mergedPositionsFromLogs(paths, 2);
+
+    std::size_t total = 0;
+    for (const std::string & path : paths) total += positionsFromLog(path).size();
+    BOOST_REQUIRE_EQUAL( merged.size() , total );
+
+    // None of these logs crosses midnight, so the time stamps are in order.
+    double previous = 0;
+    for (double timeStamp : merged.timeStamps())
+    {
+        if (std::isnan(timeStamp)) continue;
+        BOOST_CHECK( timeStamp >= previous );
+        previous = timeStamp;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( MergeOrder )
+{
+    const std::string first = writeLog("multiLog-tests-1.log",
+        { gllSentence("100000", 10), gllSentence("100030", 11), gllSentence("235959", 12), gllSentence("000001", 13) });
+    const std::string second = writeLog("multiLog-tests-2.log",
+        { gllSentence("100020", 20), gllSentence("100030", 21), gllSentence("120000", 22) });
+
+    const PositionBatch merged = mergedPositionsFromLogs({ first, second }, 2);
+
+    // Ties are broken by file, and times after midnight follow those before it.
+    const std::vector<int> expectedMinutes = { 10, 20, 11, 21, 22, 12, 13 };
+    BOOST_REQUIRE_EQUAL( merged.size() , expectedMinutes.size() );
+    for (std::size_t i = 0; i < expectedMinutes.size(); ++i)
+    {
+        BOOST_CHECK_CLOSE( merged.latitudes()[i] , 54 + expectedMinutes[i] / 60.0 , 0.0001 );
+    }
+
+    std::filesystem::remove(first);
+    std::filesystem::remove(second);
+}
+
+BOOST_AUTO_TEST_CASE( Directory )
+{
+    const std::vector<std::string> files = logFilesIn(LogFiles::NMEALogsDir);
+    BOOST_REQUIRE_EQUAL( files.size() , logFilenames.size() );
+    BOOST_CHECK( std::is_sorted(files.begin(), files.end()) );
+    BOOST_CHECK( logFilesIn(LogFiles::NMEALogsDir, ".gpx").empty() );
+
+    BOOST_CHECK_THROW( logFilesIn(LogFiles::NMEALogsDir + "nonexistent/") , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( MissingFile )
+{
+    std::vector<std::string> paths = logPaths();
+    paths.push_back(LogFiles::NMEALogsDir + "nonexistent.log");
+    BOOST_CHECK_THROW( positionsFromLogs(paths, 2) , std::invalid_argument );
+
+    BOOST_CHECK( positionsFromLogs({}).empty() );
+    BOOST_CHECK( mergedPositionsFromLogs({}).empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
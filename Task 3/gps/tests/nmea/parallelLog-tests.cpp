@@ -0,0 +1,140 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+
+#ifdef __unix__
+  #include <sys/stat.h>
+#endif
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "mappedFile.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* The file-based positionsFromLog() must give exactly the same Positions, in the same
+ * order, as the stream-based version, whatever the number of threads.  The supplied
+ * logs are small enough to be decoded on a single thread, so a larger log is also
+ * assembled from them to exercise the chunking.
+ */
+
+BOOST_AUTO_TEST_SUITE( PositionsFromLogFile )
+
+const std::vector<std::string> logFilenames = {"gll.log", "gga_rmc-1.log", "gga_rmc-2.log"};
+
+void checkPositionsEqual(const std::vector<Position> & actual, const std::vector<Position> & expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].latitude() , expected[i].latitude() );
+        BOOST_CHECK_EQUAL( actual[i].longitude() , expected[i].longitude() );
+        BOOST_CHECK_EQUAL( actual[i].elevation() , expected[i].elevation() );
+    }
+}
+
+void checkMatchesStreamVersion(const std::string & logFilepath)
+{
+    std::ifstream log{logFilepath};
+    BOOST_REQUIRE_MESSAGE( log.good() , "Could not open log file: " + logFilepath );
+    const std::vector<Position> expected = positionsFromLog(log);
+
+    for (unsigned int numThreads : {0u, 1u, 2u, 3u, 8u})
+    {
+        BOOST_TEST_CONTEXT( "Threads: " << numThreads )
+        {
+            checkPositionsEqual(positionsFromLog(logFilepath, numThreads), expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( MatchesStreamVersion )
+{
+    for (const std::string & filename : logFilenames)
+    {
+        checkMatchesStreamVersion(LogFiles::NMEALogsDir + filename);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( LargeLogMatchesStreamVersion )
+{
+    const std::filesystem::path largeLog = std::filesystem::temp_directory_path() / "parallelLog-tests.log";
+    {
+        std::ofstream output{largeLog};
+        for (int repeat = 0; repeat < 10; ++repeat)
+        {
+            for (const std::string & filename : logFilenames)
+            {
+                output << std::ifstream{LogFiles::NMEALogsDir + filename}.rdbuf();
+            }
+        }
+        output << "$GPGLL,5425.31,N,107.03,W,82610*69"; // no final line break
+    }
+
+    checkMatchesStreamVersion(largeLog.string());
+
+    std::filesystem::remove(largeLog);
+}
+
+BOOST_AUTO_TEST_CASE( EmptyLog )
+{
+    const std::filesystem::path emptyLog = std::filesystem::temp_directory_path() / "parallelLog-tests-empty.log";
+    std::ofstream{emptyLog};
+
+    BOOST_CHECK( positionsFromLog(emptyLog.string()).empty() );
+
+    std::filesystem::remove(emptyLog);
+}
+
+BOOST_AUTO_TEST_CASE( MissingFile )
+{
+    BOOST_CHECK_THROW( positionsFromLog(LogFiles::NMEALogsDir + "no-such-file.log") , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( Directory )
+{
+    BOOST_CHECK_THROW( MappedFile{LogFiles::NMEALogsDir} , std::invalid_argument );
+    BOOST_CHECK_THROW( positionsFromLog(LogFiles::NMEALogsDir) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( NonRegularFile )
+{
+    // procfs files report a size of zero, but are not empty.
+    const std::string procFile = "/proc/self/status";
+    if (! std::filesystem::exists(procFile)) return;
+
+    BOOST_CHECK( ! MappedFile{procFile}.contents().empty() );
+}
+
+#ifdef __unix__
+
+BOOST_AUTO_TEST_CASE( Fifo )
+{
+    const std::string logFilepath = LogFiles::NMEALogsDir + "gga_rmc-1.log";
+    const std::filesystem::path fifo = std::filesystem::temp_directory_path() / "parallelLog-tests.fifo";
+    std::filesystem::remove(fifo);
+    BOOST_REQUIRE( ::mkfifo(fifo.c_str(), 0600) == 0 );
+
+    // Opening a FIFO blocks until both ends are open, so write it on another thread.
+    std::thread writer([&]()
+    {
+        std::ofstream output{fifo};
+        output << std::ifstream{logFilepath}.rdbuf();
+    });
+    const std::vector<Position> actual = positionsFromLog(fifo.string());
+    writer.join();
+
+    checkPositionsEqual(actual, positionsFromLog(logFilepath));
+    std::filesystem::remove(fifo);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
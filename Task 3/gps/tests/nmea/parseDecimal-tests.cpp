@@ -0,0 +1,99 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <fstream>
+#include <cmath>
+
+#include "logs.h"
+#include "position.h"
+#include "parseNMEA.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* parseDecimal() and parseDDM() must give bit-for-bit the same results as std::stod()
+ * and ddmTodd(), so the results are compared with exact equality rather than to
+ * within a tolerance.
+ */
+
+BOOST_AUTO_TEST_SUITE( ParseDecimal )
+
+BOOST_AUTO_TEST_CASE( MatchesStod )
+{
+    const std::vector<std::string> decimals = {
+        "0", "-0", "1", "+1", "-1", ".5", "5.", "0.1", "0.3", "-30.0", "5425.31", "00559.2458",
+        "12345678901234567", "9007199254740993", "0.1234567890123456789012345",
+        "3722.59930000000000000001", "179.99999999999999"
+    };
+    for (const std::string & decimal : decimals)
+    {
+        BOOST_CHECK_EQUAL( parseDecimal(decimal) , std::stod(decimal) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( NegativeZero )
+{
+    BOOST_CHECK( std::signbit(parseDecimal("-0.0")) );
+}
+
+BOOST_AUTO_TEST_CASE( NotPlainDecimals )
+{
+    for (const std::string notDecimal : {"", "-", ".", "1.2.3", "1e3", " 1", "1 ", "high", "0x10", "--1", "inf"})
+    {
+        BOOST_CHECK_THROW( parseDecimal(notDecimal) , std::invalid_argument );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( ParseDDM )
+
+BOOST_AUTO_TEST_CASE( MatchesDdmToddOnLogFiles )
+{
+    for (const std::string filename : {"gll.log", "gga_rmc-1.log", "gga_rmc-2.log"})
+    {
+        std::ifstream log{LogFiles::NMEALogsDir + filename};
+        BOOST_REQUIRE_MESSAGE( log.good() , "Could not open log file: " + LogFiles::NMEALogsDir + filename );
+
+        std::string line;
+        while (std::getline(log, line))
+        {
+            if (! isWellFormedSentence(line)) continue;
+
+            // Every field that looks like a number is compared, not just the coordinates.
+            for (const std::string & field : parseSentenceData(line).dataFields)
+            {
+                if (field.empty() || field.find_first_not_of("0123456789.") != std::string::npos) continue;
+
+                BOOST_CHECK_EQUAL( parseDDM(field) , ddmTodd(field) );
+                BOOST_CHECK_EQUAL( parseDecimal(field) , std::stod(field) );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( FromDDMMatchesConstructor )
+{
+    const Position expected = Position("3722.5993",'S',"00559.2458",'E',"-4.5");
+    const Position actual = Position::fromDDM("3722.5993",'S',"00559.2458",'E',"-4.5");
+
+    BOOST_CHECK_EQUAL( actual.latitude() , expected.latitude() );
+    BOOST_CHECK_EQUAL( actual.longitude() , expected.longitude() );
+    BOOST_CHECK_EQUAL( actual.elevation() , expected.elevation() );
+}
+
+BOOST_AUTO_TEST_CASE( FromDDMInvalid )
+{
+    BOOST_CHECK_THROW( Position::fromDDM("fivethousand",'N',"107.03",'W') , std::invalid_argument );
+    BOOST_CHECK_THROW( Position::fromDDM("5425.31",'X',"107.03",'W') , std::invalid_argument );
+    BOOST_CHECK_THROW( Position::fromDDM("5425.31",'N',"107.03",'7') , std::invalid_argument );
+    BOOST_CHECK_THROW( Position::fromDDM("-5425.31",'N',"107.03",'W') , std::invalid_argument );
+    BOOST_CHECK_THROW( Position::fromDDM("9125.31",'N',"107.03",'W') , std::invalid_argument );
+    BOOST_CHECK_THROW( Position::fromDDM("5425.31",'N',"107.03",'W',"high") , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "positionBatch.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( PositionBatchTests )
+
+const std::vector<std::string> logFilenames = { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" };
+
+SentenceView viewOf(const std::string & sentence)
+{
+    SentenceView view;
+    BOOST_REQUIRE( scanSentence(sentence, view) == SentenceStatus::ok );
+    return view;
+}
+
+BOOST_AUTO_TEST_CASE( Columns )
+{
+    PositionBatch batch;
+    BOOST_CHECK( batch.empty() );
+    BOOST_CHECK( ! batch.hasTimeStamps() );
+    BOOST_CHECK( ! batch.hasFixQualities() );
+    BOOST_CHECK_THROW( batch.timeStamps() , std::domain_error );
+    BOOST_CHECK_THROW( batch.fixQualities() , std::domain_error );
+
+    batch.push_back(Position(1, 2, 3), 100, 1);
+    batch.push_back(Position(-4, -5, -6));
+
+    BOOST_REQUIRE_EQUAL( batch.size() , 2u );
+    BOOST_CHECK_EQUAL( batch.latitudes()[1] , -4 );
+    BOOST_CHECK_EQUAL( batch.longitudes()[1] , -5 );
+    BOOST_CHECK_EQUAL( batch.elevations()[1] , -6 );
+    BOOST_CHECK_EQUAL( batch[0].latitude() , 1 );
+    BOOST_CHECK_EQUAL( batch[0].longitude() , 2 );
+    BOOST_CHECK_EQUAL( batch[0].elevation() , 3 );
+
+    batch.clear();
+    BOOST_CHECK( batch.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( OptionalColumns )
+{
+    PositionBatch batch(true, true);
+    batch.push_back(Position(1, 2, 3), 100, 1);
+    batch.push_back(Position(4, 5, 6));
+
+    BOOST_REQUIRE_EQUAL( batch.timeStamps().size() , 2u );
+    BOOST_REQUIRE_EQUAL( batch.fixQualities().size() , 2u );
+    BOOST_CHECK_EQUAL( batch.timeStamps()[0] , 100 );
+    BOOST_CHECK( std::isnan(batch.timeStamps()[1]) );
+    BOOST_CHECK_EQUAL( batch.fixQualities()[0] , 1 );
+    BOOST_CHECK_EQUAL( batch.fixQualities()[1] , PositionBatch::unknownFixQuality );
+}
+
+BOOST_AUTO_TEST_CASE( TimeOfDay )
+{
+    BOOST_CHECK_EQUAL( timeOfDay(viewOf("$GPGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*7A")) , 9*3600 + 46*60 + 27 );
+    BOOST_CHECK_EQUAL( timeOfDay(viewOf("$GPRMC,094627.000,A,3723.1622,N,00559.5788,W,0.000,0.00,150914,,A*6F")) , 9*3600 + 46*60 + 27 );
+    BOOST_CHECK_EQUAL( timeOfDay(viewOf("$GPGLL,5425.32,N,107.11,W,82319*65")) , 8*3600 + 23*60 + 19 );
+    BOOST_CHECK( std::isnan(timeOfDay(viewOf("$GPGLL,5425.32,N,107.11,W*78"))) );
+    BOOST_CHECK( std::isnan(timeOfDay(viewOf("$GPGLL,5425.32,N,107.11,W,86319*61"))) );
+}
+
+BOOST_AUTO_TEST_CASE( FixQuality )
+{
+    BOOST_CHECK_EQUAL( fixQuality(viewOf("$GPGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*7A")) , 1 );
+    BOOST_CHECK_EQUAL( fixQuality(viewOf("$GPRMC,094627.000,A,3723.1622,N,00559.5788,W,0.000,0.00,150914,,A*6F")) , 1 );
+    BOOST_CHECK_EQUAL( fixQuality(viewOf("$GPGLL,5425.32,N,107.11,W,82319*65")) , PositionBatch::unknownFixQuality );
+}
+
+BOOST_AUTO_TEST_CASE( MatchesPositionsFromLog )
+{
+    PositionBatch batch(true, true);
+    std::size_t expectedSize = 0;
+    for (const std::string & filename : logFilenames)
+    {
+        const std::string filePath = LogFiles::NMEALogsDir + filename;
+        const std::vector<Position> positions = positionsFromLog(filePath, 1);
+
+        // Appends to what is already in the batch.
+        const std::size_t offset = batch.size();
+        positionsFromLogInto(filePath, batch);
+        expectedSize += positions.size();
+        BOOST_REQUIRE_EQUAL( batch.size() , expectedSize );
+
+        for (std::size_t i = 0; i < positions.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL( batch.latitudes()[offset + i] , positions[i].latitude() );
+            BOOST_CHECK_EQUAL( batch.longitudes()[offset + i] , positions[i].longitude() );
+            BOOST_CHECK_EQUAL( batch.elevations()[offset + i] , positions[i].elevation() );
+            BOOST_CHECK( ! std::isnan(batch.timeStamps()[offset + i]) );
+        }
+    }
+    BOOST_CHECK_EQUAL( batch.timeStamps().size() , batch.size() );
+    BOOST_CHECK_EQUAL( batch.fixQualities().size() , batch.size() );
+}
+
+BOOST_AUTO_TEST_CASE( StreamVersion )
+{
+    std::stringstream log;
+    log << "$GPGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*7A\n"
+        << "$GPGLL,5425.32,N,107.11,W,82319*65\n"
+        << "$GPGLL,5425.32,N,107.11,W,82319*66\n"; // bad checksum
+
+    PositionBatch batch(true);
+    positionsFromLogInto(log, batch);
+
+    BOOST_REQUIRE_EQUAL( batch.size() , 2u );
+    BOOST_CHECK_EQUAL( batch.timeStamps()[0] , 9*3600 + 46*60 + 27 );
+    BOOST_CHECK_EQUAL( batch.timeStamps()[1] , 8*3600 + 23*60 + 19 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "positionCache.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( PositionCacheTests )
+
+const std::filesystem::path tempDir = std::filesystem::temp_directory_path();
+
+void checkSamePositions(const std::vector<Position> & actual, const std::vector<Position> & expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].latitude() , expected[i].latitude() );
+        BOOST_CHECK_EQUAL( actual[i].longitude() , expected[i].longitude() );
+        BOOST_CHECK_EQUAL( actual[i].elevation() , expected[i].elevation() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    const std::string logPath = LogFiles::NMEALogsDir + "gga_rmc-2.log";
+    const std::string cachePath = (tempDir / "positionCache-tests.poscache").string();
+
+    PositionBatch batch(true);
+    positionsFromLogInto(logPath, batch);
+    writePositionCache(cachePath, batch, sourceKeyOf(logPath));
+
+    {
+        const PositionCache cache(cachePath);
+        BOOST_REQUIRE_EQUAL( cache.size() , batch.size() );
+        BOOST_CHECK( cache.sourceKey() == sourceKeyOf(logPath) );
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL( cache.latitudes()[i] , batch.latitudes()[i] );
+            BOOST_CHECK_EQUAL( cache.longitudes()[i] , batch.longitudes()[i] );
+            BOOST_CHECK_EQUAL( cache.elevations()[i] , batch.elevations()[i] );
+            BOOST_CHECK_EQUAL( cache.timeStamps()[i] , batch.timeStamps()[i] );
+        }
+        checkSamePositions(cache.positions(), positionsFromLog(logPath));
+
+        PositionBatch appended(true);
+        cache.appendTo(appended);
+        cache.appendTo(appended);
+        BOOST_CHECK_EQUAL( appended.size() , 2 * batch.size() );
+    }
+    std::filesystem::remove(cachePath);
+}
+
+BOOST_AUTO_TEST_CASE( FromVector )
+{
+    const std::string cachePath = (tempDir / "positionCache-tests-vector.poscache").string();
+    const std::vector<Position> positions = positionsFromLog(LogFiles::NMEALogsDir + "gll.log");
+    writePositionCache(cachePath, positions);
+
+    {
+        const PositionCache cache(cachePath);
+        checkSamePositions(cache.positions(), positions);
+        BOOST_REQUIRE( cache.size() > 0 );
+        BOOST_CHECK( std::isnan(cache.timeStamps()[0]) );
+        BOOST_CHECK( cache.sourceKey() == SourceKey{} );
+    }
+    std::filesystem::remove(cachePath);
+}
+
+BOOST_AUTO_TEST_CASE( InvalidFiles )
+{
+    BOOST_CHECK_THROW( PositionCache(LogFiles::NMEALogsDir + "nonexistent.poscache") , std::invalid_argument );
+    BOOST_CHECK_THROW( PositionCache(LogFiles::NMEALogsDir + "gll.log") , std::domain_error );
+
+    const std::string cachePath = (tempDir / "positionCache-tests-truncated.poscache").string();
+    writePositionCache(cachePath, positionsFromLog(LogFiles::NMEALogsDir + "gll.log"));
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 8);
+    BOOST_CHECK_THROW( PositionCache{cachePath} , std::domain_error );
+    std::filesystem::remove(cachePath);
+}
+
+BOOST_AUTO_TEST_CASE( TemporaryPaths )
+{
+    const std::string cachePath = (tempDir / "positionCache-tests.poscache").string();
+    const std::string first = temporaryPathFor(cachePath);
+    const std::string second = temporaryPathFor(cachePath);
+    BOOST_CHECK( first != second );
+    BOOST_CHECK_EQUAL( first.compare(0, cachePath.size() + 5, cachePath + ".tmp.") , 0 );
+    BOOST_CHECK_EQUAL( second.compare(0, cachePath.size() + 5, cachePath + ".tmp.") , 0 );
+}
+
+BOOST_AUTO_TEST_CASE( AutomaticCache )
+{
+    const std::filesystem::path logPath = tempDir / "positionCache-tests.log";
+    std::filesystem::copy_file(LogFiles::NMEALogsDir + "gga_rmc-1.log", logPath,
+                               std::filesystem::copy_options::overwrite_existing);
+    const std::string cachePath = cachePathFor(logPath.string());
+    std::filesystem::remove(cachePath);
+
+    const std::vector<Position> expected = positionsFromLog(logPath.string());
+
+    // The first use decodes the log and writes the cache...
+    checkSamePositions(cachedPositionsFromLog(logPath.string()), expected);
+    BOOST_REQUIRE( std::filesystem::exists(cachePath) );
+    BOOST_CHECK( PositionCache(cachePath).sourceKey() == sourceKeyOf(logPath.string()) );
+
+    // ...which later uses read.
+    checkSamePositions(cachedPositionsFromLog(logPath.string()), expected);
+    PositionBatch batch;
+    cachedPositionsFromLogInto(logPath.string(), batch);
+    BOOST_CHECK_EQUAL( batch.size() , expected.size() );
+
+    // Changing the log invalidates the cache.
+    {
+        std::ofstream log{logPath, std::ios::app};
+        log << "$GPGLL,5425.32,N,107.11,W,82319*65\n";
+    }
+    const std::vector<Position> changed = cachedPositionsFromLog(logPath.string());
+    BOOST_CHECK_EQUAL( changed.size() , expected.size() + 1 );
+    BOOST_CHECK( PositionCache(cachePath).sourceKey() == sourceKeyOf(logPath.string()) );
+    BOOST_CHECK_EQUAL( PositionCache(cachePath).size() , expected.size() + 1 );
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::remove(logPath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "resyncScanner.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* The noisy test corpus is built from the logs in logs/NMEA, by injecting the kinds of
+ * noise found in raw serial captures, using a fixed seed so that it is reproducible.
+ * The sentences left intact by the noise are recorded, so that the Positions that should
+ * be recovered are known.
+ */
+
+BOOST_AUTO_TEST_SUITE( ResyncScannerTests )
+
+const std::vector<std::string> logFilenames = { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" };
+
+std::vector<std::string> linesOf(const std::string & filename)
+{
+    std::ifstream log{LogFiles::NMEALogsDir + filename};
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(log, line)) lines.push_back(line);
+    return lines;
+}
+
+struct NoisyLog
+{
+    std::string buffer;
+    std::string intactLines; // the lines of the original log that survive intact
+};
+
+NoisyLog injectNoise(const std::vector<std::string> & lines, unsigned int seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> anyByte(0, 255);
+
+    NoisyLog noisy;
+    for (const std::string & line : lines)
+    {
+        const int noise = percent(random);
+        if (noise < 10)
+        {
+            // Binary garbage in place of a line break, so two sentences share a line.
+            noisy.buffer += line;
+            for (int i = percent(random) % 8; i > 0; --i) noisy.buffer += static_cast<char>(anyByte(random));
+            noisy.intactLines += line + "\n";
+        }
+        else if (noise < 20 && line.size() > 10)
+        {
+            // A truncated sentence.
+            noisy.buffer += line.substr(0, line.size() / 2) + "\n";
+        }
+        else if (noise < 30 && line.size() > 10)
+        {
+            // A corrupted character, which cannot be another start marker.
+            std::string corrupted = line;
+            const std::size_t pos = 1 + percent(random) % (line.size() - 4);
+            corrupted[pos] = (corrupted[pos] == '#') ? '%' : '#';
+            noisy.buffer += corrupted + "\n";
+        }
+        else if (noise < 35)
+        {
+            // No line break at all.
+            noisy.buffer += line;
+            noisy.intactLines += line + "\n";
+        }
+        else
+        {
+            noisy.buffer += line + "\r\n";
+            noisy.intactLines += line + "\n";
+        }
+    }
+    return noisy;
+}
+
+void checkSamePositions(const std::vector<Position> & actual, const std::vector<Position> & expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( actual[i].latitude() , expected[i].latitude() );
+        BOOST_CHECK_EQUAL( actual[i].longitude() , expected[i].longitude() );
+        BOOST_CHECK_EQUAL( actual[i].elevation() , expected[i].elevation() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( CleanLogs )
+{
+    for (const std::string & filename : logFilenames)
+    {
+        std::string log;
+        for (const std::string & line : linesOf(filename)) log += line + "\n";
+
+        IngestStats stats;
+        checkSamePositions(positionsFromNoisyBuffer(log, TalkerSet::gps(), &stats), positionsFromBuffer(log));
+        BOOST_CHECK_EQUAL( stats.bytesRead , log.size() );
+        BOOST_CHECK_EQUAL( stats.rejected() , 0u );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( NoisyCorpus )
+{
+    for (const std::string & filename : logFilenames)
+    {
+        for (unsigned int seed : { 1u, 2u, 3u })
+        {
+            const NoisyLog noisy = injectNoise(linesOf(filename), seed);
+            const std::vector<Position> expected = positionsFromBuffer(noisy.intactLines);
+
+            IngestStats stats;
+            checkSamePositions(positionsFromNoisyBuffer(noisy.buffer, TalkerSet::gps(), &stats), expected);
+            BOOST_CHECK_EQUAL( stats.accepted() , expected.size() );
+            BOOST_CHECK( stats.badChecksum > 0 );
+
+            // Line-based decoding loses the sentences that share a line.
+            BOOST_CHECK( positionsFromBuffer(noisy.buffer).size() < expected.size() );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( SeveralSentencesOnALine )
+{
+    const std::string gll = "$GPGLL,5425.32,N,107.11,W,82319*65";
+    const std::string buffer = "\x01\xFF$GP" + gll + "*" + gll + "$$" + gll + "\n$GPGLL,5425" + gll;
+
+    ResyncScanner scanner(buffer);
+    SentenceView sentence;
+    std::size_t found = 0;
+    while (scanner.next(sentence))
+    {
+        ++found;
+        BOOST_CHECK_EQUAL( sentence.format() , "GLL" );
+        BOOST_CHECK_EQUAL( sentence.field(4) , "82319" );
+    }
+    BOOST_CHECK_EQUAL( found , 4u );
+    BOOST_CHECK_EQUAL( scanner.offset() , buffer.size() );
+}
+
+BOOST_AUTO_TEST_CASE( ChecksumCharactersStartNextSentence )
+{
+    // A candidate whose "checksum" is the start of the next sentence.
+    const std::string gll = "$GPGLL,5425.32,N,107.11,W,82319*65";
+    checkSamePositions(positionsFromNoisyBuffer("$GPGLL,5425.32,*" + gll), positionsFromBuffer(gll));
+}
+
+BOOST_AUTO_TEST_CASE( OverlongAndTruncatedCandidates )
+{
+    const std::string gll = "$GPGLL,5425.32,N,107.11,W,82319*65";
+    const std::string overlong = "$GPGLL," + std::string(ResyncScanner::maxSentenceLength, '0') + "*00";
+
+    IngestStats stats;
+    BOOST_CHECK_EQUAL( positionsFromNoisyBuffer(overlong + gll + gll.substr(0, 20), TalkerSet::gps(), &stats).size() , 1u );
+    BOOST_CHECK_EQUAL( stats.linesRead , 1u ); // abandoned candidates are not counted
+    BOOST_CHECK( positionsFromNoisyBuffer(gll.substr(0, gll.size() - 1)).empty() );
+    BOOST_CHECK( positionsFromNoisyBuffer("").empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "logs.h"
+#include "parseNMEA.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* scanSentence() fuses isWellFormedSentence(), hasCorrectChecksum(),
+ * isSupportedSentenceFormat() and parseSentenceView() into a single pass, so the
+ * main test consideration is that it agrees with those functions on every input.
+ */
+
+BOOST_AUTO_TEST_SUITE( ScanSentence )
+
+SentenceStatus expectedStatus(const std::string & candidate)
+{
+    if (! isWellFormedSentence(candidate)) return SentenceStatus::malformed;
+    if (! hasCorrectChecksum(candidate)) return SentenceStatus::badChecksum;
+    if (! isSupportedSentenceFormat(candidate.substr(3,3))) return SentenceStatus::unsupportedFormat;
+    return SentenceStatus::ok;
+}
+
+void checkScanAgrees(const std::string & candidate)
+{
+    SentenceView view;
+    const SentenceStatus actual = scanSentence(candidate, view);
+    const SentenceStatus expected = expectedStatus(candidate);
+
+    BOOST_CHECK_MESSAGE( actual == expected , "scanSentence() disagrees on: " + candidate );
+
+    if (actual == SentenceStatus::ok && expected == SentenceStatus::ok)
+    {
+        const SentenceData data = parseSentenceData(candidate);
+        BOOST_CHECK_EQUAL( std::string(view.format()) , data.format );
+        BOOST_REQUIRE_EQUAL( view.numFields() , data.dataFields.size() );
+        for (std::size_t i = 0; i < view.numFields(); ++i)
+        {
+            BOOST_CHECK_EQUAL( std::string(view.field(i)) , data.dataFields[i] );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( StatusOk )
+{
+    SentenceView view;
+    BOOST_CHECK( scanSentence("$GPGLL,5425.31,N,107.03,W,82610*69", view) == SentenceStatus::ok );
+    BOOST_CHECK( scanSentence("$GPRMC,113922.000,A,3722.5993,N,00559.2458,W,0.000,0.00,150914,,A*62", view) == SentenceStatus::ok );
+}
+
+BOOST_AUTO_TEST_CASE( StatusMalformed )
+{
+    SentenceView view;
+    BOOST_CHECK( scanSentence("", view) == SentenceStatus::malformed );
+    BOOST_CHECK( scanSentence("$GPGLL", view) == SentenceStatus::malformed );
+    BOOST_CHECK( scanSentence("$GPGLL*69", view) == SentenceStatus::malformed );
+    BOOST_CHECK( scanSentence("$GPXXX,$77*01", view) == SentenceStatus::malformed );
+    BOOST_CHECK( scanSentence("$GPXXX,2*3,1*77", view) == SentenceStatus::malformed );
+    BOOST_CHECK( scanSentence("$GPXXX,*012", view) == SentenceStatus::malformed );
+    BOOST_CHECK( scanSentence("$GPXXX,*3g", view) == SentenceStatus::malformed );
+    BOOST_CHECK( scanSentence("@Sonygps/ver3.0/wgs-84", view) == SentenceStatus::malformed );
+}
+
+BOOST_AUTO_TEST_CASE( StatusBadChecksum )
+{
+    SentenceView view;
+    BOOST_CHECK( scanSentence("$GPGLL,5425.31,N,107.03,W,82610*24", view) == SentenceStatus::badChecksum );
+    BOOST_CHECK( scanSentence("$GPMSS,55,27,318.0,100,*67", view) == SentenceStatus::badChecksum );
+}
+
+BOOST_AUTO_TEST_CASE( StatusUnsupportedFormat )
+{
+    SentenceView view;
+    BOOST_CHECK( scanSentence("$GPMSS,55,27,318.0,100,*66", view) == SentenceStatus::unsupportedFormat );
+    BOOST_CHECK( scanSentence("$GPXXX,*63", view) == SentenceStatus::unsupportedFormat );
+}
+
+BOOST_AUTO_TEST_CASE( TooManyFields )
+{
+    SentenceView view;
+    const std::string commas(SentenceView::maxFields + 1, ','); // one more field than the maximum
+    BOOST_CHECK( scanSentence("$GPXXX" + commas + "*88", view) == SentenceStatus::malformed );
+}
+
+BOOST_AUTO_TEST_CASE( AgreesWithSeparatePasses )
+{
+    const std::vector<std::string> candidates = {
+        "$GPXXX,1*23", "$GPXXX,*af", "$GPXXX,*DC", "$GPAAA,*7a", "$GPAAE,*5f",
+        "SGPXXX,*01", "$HPXXX,*01", "$GPX%X,*01", "$GPXXX*01", "$GPXX,X77",
+        "$GPGGA,113922.000,3722.5993,N,00559.2458,W,1,0,,4.0,M,,M,,*40",
+        "$GPGGA,113922.000,3722.5993,N,00559.2458,W,1,0,,4.0,M,,M,,*41"
+    };
+    for (const std::string & candidate : candidates) checkScanAgrees(candidate);
+}
+
+BOOST_AUTO_TEST_CASE( AgreesWithSeparatePassesOnLogFiles )
+{
+    for (const std::string filename : {"gll.log", "gga_rmc-1.log", "gga_rmc-2.log"})
+    {
+        std::ifstream log{LogFiles::NMEALogsDir + filename};
+        BOOST_REQUIRE_MESSAGE( log.good() , "Could not open log file: " + LogFiles::NMEALogsDir + filename );
+
+        std::string line;
+        while (std::getline(log, line)) checkScanAgrees(line);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
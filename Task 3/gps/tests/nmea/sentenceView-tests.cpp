@@ -0,0 +1,141 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+#include "parseNMEA.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* A SentenceView should present exactly the same format and data fields as the
+ * corresponding SentenceData, but without copying them out of the sentence buffer.
+ */
+
+BOOST_AUTO_TEST_SUITE( ParseSentenceView )
+
+void checkViewMatchesData(const std::string & sentence)
+{
+    const SentenceData expected = parseSentenceData(sentence);
+    const SentenceView actual = parseSentenceView(sentence);
+
+    BOOST_CHECK_EQUAL( std::string(actual.format()) , expected.format );
+    BOOST_REQUIRE_EQUAL( actual.numFields() , expected.dataFields.size() );
+    for (std::size_t i = 0; i < actual.numFields(); ++i)
+    {
+        BOOST_CHECK_EQUAL( std::string(actual.field(i)) , expected.dataFields[i] );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( MatchesSentenceData )
+{
+    checkViewMatchesData("$GPAAA,1*4b");
+    checkViewMatchesData("$GPXXX,*63");
+    checkViewMatchesData("$GPGLL,5425.31,N,107.03,W,82610*69");
+    checkViewMatchesData("$GPGGA,114530.000,3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,*4E");
+    checkViewMatchesData("$GPRMC,115856.000,A,3722.6710,N,00559.3014,W,0.000,0.00,150914,,A*6d");
+    checkViewMatchesData("$GPMSS,55,27,318.0,100,*66");
+}
+
+BOOST_AUTO_TEST_CASE( FieldsPointIntoSentenceBuffer )
+{
+    const std::string sentence = "$GPGLL,5425.31,N,107.03,W,82610*69";
+    const SentenceView view = parseSentenceView(sentence);
+
+    BOOST_CHECK( view.format().data() == sentence.data() + 3 );
+    BOOST_CHECK( view.field(0).data() == sentence.data() + 7 );
+}
+
+BOOST_AUTO_TEST_CASE( FieldIndexOutOfRange )
+{
+    const SentenceView view = parseSentenceView("$GPGLL,5425.31,N,107.03,W,82610*69");
+
+    BOOST_CHECK_THROW( view.field(5) , std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( FieldsBeyondInlineStorage )
+{
+    std::string sentence = "$GPXXX";
+    for (std::size_t i = 0; i < SentenceView::inlineFields + 10; ++i) sentence += "," + std::to_string(i);
+    sentence += "*00";
+    checkViewMatchesData(sentence);
+
+    const SentenceView view = parseSentenceView(sentence);
+    const SentenceView copy = view;
+    BOOST_CHECK_EQUAL( copy.field(SentenceView::inlineFields + 9) , std::to_string(SentenceView::inlineFields + 9) );
+
+    // Reusing a view for a shorter sentence discards the spilled fields.
+    SentenceView reused = view;
+    BOOST_REQUIRE( scanSentence("$GPGLL,5425.31,N,107.03,W,82610*69", reused) == SentenceStatus::ok );
+    BOOST_CHECK_EQUAL( reused.numFields() , 5u );
+    BOOST_CHECK_EQUAL( reused.field(4) , "82610" );
+}
+
+BOOST_AUTO_TEST_CASE( TypedFields )
+{
+    const SentenceView view = parseSentenceView("$GPGGA,114530.000,3722.6279,N,00559.1566,W,1,0,,1.0,M,,M,,*4E");
+
+    BOOST_CHECK_EQUAL( view.field<double>(0) , 114530.0 );
+    BOOST_CHECK_EQUAL( view.field<double>(8) , 1.0 );
+    BOOST_CHECK_EQUAL( view.field<std::string_view>(2) , "N" );
+    BOOST_CHECK_EQUAL( view.fieldView(2) , "N" );
+    BOOST_CHECK( view.fieldView(2).data() == view.field(2).data() );
+
+    BOOST_CHECK_THROW( view.field<double>(2) , std::invalid_argument );
+    BOOST_CHECK_THROW( view.field<double>(7) , std::invalid_argument ); // empty
+    BOOST_CHECK_THROW( view.field<double>(14) , std::out_of_range );
+
+    double value = 0;
+    BOOST_CHECK( view.tryField(3, value) );
+    BOOST_CHECK_EQUAL( value , 559.1566 );
+    BOOST_CHECK( ! view.tryField(2, value) );
+    BOOST_CHECK( ! view.tryField(14, value) );
+}
+
+BOOST_AUTO_TEST_CASE( TooManyFields )
+{
+    const std::string commas(SentenceView::maxFields + 1, ','); // one more field than the maximum
+
+    BOOST_CHECK_THROW( parseSentenceView("$GPXXX" + commas + "*88") , std::length_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( InterpretSentenceView )
+
+const double percentageAccuracy = 0.0001;
+
+void checkViewInterpretationMatchesData(const std::string & sentence)
+{
+    const Position expected = interpretSentenceData(parseSentenceData(sentence));
+    const Position actual = interpretSentenceData(parseSentenceView(sentence));
+
+    BOOST_CHECK_CLOSE( actual.latitude() , expected.latitude() , percentageAccuracy );
+    BOOST_CHECK_CLOSE( actual.longitude() , expected.longitude() , percentageAccuracy );
+    BOOST_CHECK_CLOSE( actual.elevation() , expected.elevation() , percentageAccuracy );
+}
+
+BOOST_AUTO_TEST_CASE( SupportedFormats )
+{
+    checkViewInterpretationMatchesData("$GPGLL,5425.31,N,107.03,W,82610*69");
+    checkViewInterpretationMatchesData("$GPGGA,114530.000,3722.6279,S,00559.1566,E,1,0,,-1.0,M,,M,,*4E");
+    checkViewInterpretationMatchesData("$GPRMC,115856.000,A,3722.6710,N,00559.3014,W,0.000,0.00,150914,,A*6d");
+}
+
+BOOST_AUTO_TEST_CASE( UnsupportedFormat )
+{
+    BOOST_CHECK_THROW( interpretSentenceData(parseSentenceView("$GPMSS,55,27,318.0,100,*66")) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidFields )
+{
+    BOOST_CHECK_THROW( interpretSentenceData(parseSentenceView("$GPGLL,5425.31,107.03,W,82610*0B")) , std::invalid_argument );
+    BOOST_CHECK_THROW( interpretSentenceData(parseSentenceView("$GPGLL,5425.31,X,107.03,W,82610*7F")) , std::invalid_argument );
+    BOOST_CHECK_THROW( interpretSentenceData(parseSentenceView("$GPGLL,5425.31,NN,107.03,W,82610*7F")) , std::invalid_argument );
+    BOOST_CHECK_THROW( interpretSentenceData(parseSentenceView("$GPGGA,113922.000,3722.5993,N,00559.2458,W,1,0,,high,M,,M,,*64")) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "streamDecoder.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* Feeding a log through a StreamDecoder should produce exactly the same Positions as
+ * positionsFromLog(), however the log is split into chunks.  The interesting cases
+ * are splits inside sentences, at line breaks, and single-byte chunks.
+ */
+
+BOOST_AUTO_TEST_SUITE( StreamDecoderTests )
+
+std::string readNMEAlogFile(std::string filename)
+{
+    std::ifstream log{LogFiles::NMEALogsDir + filename};
+    BOOST_REQUIRE_MESSAGE( log.good() , "Could not open log file: " + LogFiles::NMEALogsDir + filename );
+    std::stringstream contents;
+    contents << log.rdbuf();
+    return contents.str();
+}
+
+std::vector<Position> decodeInChunks(const std::string & log, std::size_t chunkSize)
+{
+    std::vector<Position> positions;
+    StreamDecoder decoder([&](const Position & position) { positions.push_back(position); });
+    for (std::size_t start = 0; start < log.size(); start += chunkSize)
+    {
+        decoder.feed(log.data() + start, std::min(chunkSize, log.size() - start));
+    }
+    decoder.finish();
+    return positions;
+}
+
+void checkMatchesPositionsFromLog(const std::string & log)
+{
+    std::stringstream logStream(log);
+    const std::vector<Position> expected = positionsFromLog(logStream);
+
+    for (std::size_t chunkSize : {1, 2, 7, 33, 82, 4096, 1000000})
+    {
+        BOOST_TEST_CONTEXT( "Chunk size: " << chunkSize )
+        {
+            const std::vector<Position> actual = decodeInChunks(log, chunkSize);
+            BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+            for (std::size_t i = 0; i < actual.size(); ++i)
+            {
+                BOOST_CHECK_EQUAL( actual[i].latitude() , expected[i].latitude() );
+                BOOST_CHECK_EQUAL( actual[i].longitude() , expected[i].longitude() );
+                BOOST_CHECK_EQUAL( actual[i].elevation() , expected[i].elevation() );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( LargeLogs )
+{
+    checkMatchesPositionsFromLog(readNMEAlogFile("gll.log"));
+    checkMatchesPositionsFromLog(readNMEAlogFile("gga_rmc-1.log"));
+    checkMatchesPositionsFromLog(readNMEAlogFile("gga_rmc-2.log"));
+}
+
+BOOST_AUTO_TEST_CASE( FinalLineWithoutLineBreak )
+{
+    const std::string log = "$GPGLL,5425.31,N,107.03,W,82610*69\n$GPGLL,5425.31,N,107.03,W,82610*69";
+
+    BOOST_CHECK_EQUAL( decodeInChunks(log, 5).size() , 2u );
+}
+
+BOOST_AUTO_TEST_CASE( CRLFLineBreaks )
+{
+    const std::string sentence = "$GPGLL,5425.31,N,107.03,W,82610*69";
+    const std::string log = sentence + "\r\n" + sentence + "\n\r\n" + sentence + "\r\n" + sentence + "\r";
+
+    for (std::size_t chunkSize : {1, 35, 36, 1000000})
+    {
+        BOOST_CHECK_EQUAL( decodeInChunks(log, chunkSize).size() , 4u );
+    }
+    checkMatchesPositionsFromLog(log);
+}
+
+BOOST_AUTO_TEST_CASE( LargeLogsWithCRLFLineBreaks )
+{
+    const std::string log = readNMEAlogFile("gga_rmc-1.log");
+    std::string crlfLog;
+    for (char c : log)
+    {
+        if (c == '\n') crlfLog += '\r';
+        crlfLog += c;
+    }
+
+    std::stringstream logStream(log);
+    BOOST_CHECK_EQUAL( decodeInChunks(crlfLog, 4096).size() , positionsFromLog(logStream).size() );
+    checkMatchesPositionsFromLog(crlfLog);
+}
+
+BOOST_AUTO_TEST_CASE( GenericLambdaHandlers )
+{
+    const std::string log = "$GPGLL,5425.31,N,107.03,W,82610*69\n";
+    std::size_t numPositions = 0;
+    std::size_t numFixes = 0;
+
+    StreamDecoder decoder([&](const auto &) { ++numPositions; });
+    decoder.feed(log.data(), log.size());
+    decoder.finish();
+
+    StreamDecoder fusingDecoder = StreamDecoder::fusingEpochs([&](const auto &) { ++numFixes; });
+    fusingDecoder.feed(log.data(), log.size());
+    fusingDecoder.finish();
+
+    BOOST_CHECK_EQUAL( numPositions , 1u );
+    BOOST_CHECK_EQUAL( numFixes , 1u );
+}
+
+BOOST_AUTO_TEST_CASE( OverlongLinesDiscarded )
+{
+    const std::string overlongLine(StreamDecoder::maxLineLength + 1, 'X');
+    const std::string log = overlongLine + "\n$GPGLL,5425.31,N,107.03,W,82610*69\n" + overlongLine;
+
+    for (std::size_t chunkSize : {1, 100, 1000000})
+    {
+        BOOST_CHECK_EQUAL( decodeInChunks(log, chunkSize).size() , 1u );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <sstream>
+#include <vector>
+
+#include "parseNMEA.h"
+#include "streamDecoder.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* By default only the "GP" talker ID is accepted, so the existing behaviour is
+ * unchanged; other talker IDs are only accepted when configured.
+ */
+
+BOOST_AUTO_TEST_SUITE( Talkers )
+
+// The same GGA sentence from different talkers (each with a correct checksum).
+const std::string gpSentence = "$GPGGA,113922.000,3722.5993,N,00559.2458,W,1,0,,4.0,M,,M,,*40";
+const std::string gnSentence = "$GNGGA,113922.000,3722.5993,N,00559.2458,W,1,0,,4.0,M,,M,,*5E";
+const std::string glSentence = "$GLGGA,113922.000,3722.5993,N,00559.2458,W,1,0,,4.0,M,,M,,*5C";
+const std::string bdSentence = "$BDGGA,113922.000,3722.5993,N,00559.2458,W,1,0,,4.0,M,,M,,*51";
+
+BOOST_AUTO_TEST_CASE( TalkerSetMembership )
+{
+    const TalkerSet talkers = {"GN", "BD"};
+
+    BOOST_CHECK( talkers.contains("GN") );
+    BOOST_CHECK( talkers.contains('B','D') );
+    BOOST_CHECK( ! talkers.contains("GP") );
+    BOOST_CHECK( ! talkers.contains("G") );
+    BOOST_CHECK( ! talkers.contains("GNX") );
+    BOOST_CHECK( ! talkers.contains('g','n') );
+    BOOST_CHECK( ! talkers.contains('$','@') );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidTalkerIDs )
+{
+    BOOST_CHECK_THROW( TalkerSet({"G"}) , std::invalid_argument );
+    BOOST_CHECK_THROW( TalkerSet({"gp"}) , std::invalid_argument );
+    BOOST_CHECK_THROW( TalkerSet({"G1"}) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( DefaultIsGPSOnly )
+{
+    SentenceView view;
+
+    BOOST_CHECK( isWellFormedSentence(gpSentence) );
+    BOOST_CHECK( ! isWellFormedSentence(gnSentence) );
+    BOOST_CHECK( scanSentence(gpSentence, view) == SentenceStatus::ok );
+    BOOST_CHECK( scanSentence(gnSentence, view) == SentenceStatus::malformed );
+}
+
+BOOST_AUTO_TEST_CASE( ConfiguredTalkers )
+{
+    const TalkerSet talkers = {"GN", "GL"};
+    SentenceView view;
+
+    BOOST_CHECK( isWellFormedSentence(gnSentence, talkers) );
+    BOOST_CHECK( isWellFormedSentence(glSentence, talkers) );
+    BOOST_CHECK( ! isWellFormedSentence(gpSentence, talkers) );
+
+    BOOST_REQUIRE( scanSentence(gnSentence, view, talkers) == SentenceStatus::ok );
+    BOOST_CHECK_EQUAL( std::string(view.talker()) , "GN" );
+    BOOST_CHECK_EQUAL( std::string(view.format()) , "GGA" );
+    BOOST_CHECK( scanSentence(bdSentence, view, talkers) == SentenceStatus::malformed );
+}
+
+BOOST_AUTO_TEST_CASE( PerTalkerCounts )
+{
+    std::stringstream log;
+    log << gpSentence << std::endl << gnSentence << std::endl << gnSentence << std::endl
+        << bdSentence << std::endl << glSentence << std::endl;
+
+    TalkerCounts counts;
+    const std::vector<Position> positions = positionsFromLog(log, {"GP", "GN", "BD"}, &counts);
+
+    BOOST_CHECK_EQUAL( positions.size() , 4u );
+    BOOST_CHECK_EQUAL( counts["GP"] , 1u );
+    BOOST_CHECK_EQUAL( counts["GN"] , 2u );
+    BOOST_CHECK_EQUAL( counts["BD"] , 1u );
+    BOOST_CHECK_EQUAL( counts["GL"] , 0u );
+    BOOST_CHECK_EQUAL( counts.total() , 4u );
+}
+
+BOOST_AUTO_TEST_CASE( StreamDecoderCounts )
+{
+    const std::string log = gpSentence + "\n" + gnSentence + "\n" + glSentence + "\n";
+
+    unsigned int numPositions = 0;
+    StreamDecoder decoder([&](const Position &) { ++numPositions; }, TalkerSet::allConstellations());
+    decoder.feed(log.data(), log.size());
+
+    BOOST_CHECK_EQUAL( numPositions , 3u );
+    BOOST_CHECK_EQUAL( decoder.talkerCounts()["GL"] , 1u );
+    BOOST_CHECK_EQUAL( decoder.talkerCounts().total() , 3u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
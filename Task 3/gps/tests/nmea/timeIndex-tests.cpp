@@ -0,0 +1,218 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "timeIndex.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( TimeIndexTests )
+
+const std::filesystem::path tempDir = std::filesystem::temp_directory_path();
+
+std::string contentsOf(const std::string & filePath)
+{
+    std::ifstream log{filePath};
+    std::stringstream buffer;
+    buffer << log.rdbuf();
+    return buffer.str();
+}
+
+// A copy of a log in the temporary directory, with no index.
+std::string temporaryLog(const std::string & filename, const std::string & contents)
+{
+    const std::string logPath = (tempDir / filename).string();
+    std::ofstream{logPath} << contents;
+    std::filesystem::remove(timeIndexPathFor(logPath));
+    return logPath;
+}
+
+void removeLog(const std::string & logPath)
+{
+    std::filesystem::remove(timeIndexPathFor(logPath));
+    std::filesystem::remove(logPath);
+}
+
+// The Positions of a whole log timed within [from, to], for a log within one day.
+PositionBatch expectedBetween(const std::string & log, double from, double to)
+{
+    PositionBatch all(true, true);
+    positionsFromBufferInto(log, all);
+
+    PositionBatch expected(true, true);
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+        const double time = all.timeStamps()[i];
+        if (time >= from && time <= to) expected.push_back(all[i], time, all.fixQualities()[i]);
+    }
+    return expected;
+}
+
+void checkSamePositions(const PositionBatch & actual, const PositionBatch & expected)
+{
+    BOOST_REQUIRE_EQUAL( actual.size() , expected.size() );
+    BOOST_CHECK( actual.latitudes() == expected.latitudes() );
+    BOOST_CHECK( actual.longitudes() == expected.longitudes() );
+    BOOST_CHECK( actual.timeStamps() == expected.timeStamps() );
+}
+
+BOOST_AUTO_TEST_CASE( Build )
+{
+    const std::string log = contentsOf(LogFiles::NMEALogsDir + "gga_rmc-1.log");
+    const TimeIndex everyEpoch = buildTimeIndex(log, 1);
+    const TimeIndex sparse = buildTimeIndex(log, 10);
+
+    // Each epoch of this log is a GGA and an RMC sentence.
+    BOOST_CHECK_EQUAL( everyEpoch.times.size() , positionsFromBuffer(log).size() / 2 );
+    BOOST_CHECK_EQUAL( sparse.times.size() , (everyEpoch.times.size() + 9) / 10 );
+    BOOST_CHECK_EQUAL( sparse.epochsPerEntry , 10u );
+
+    for (std::size_t i = 0; i < sparse.times.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL( sparse.times[i] , everyEpoch.times[i * 10] );
+        BOOST_CHECK_EQUAL( sparse.offsets[i] , everyEpoch.offsets[i * 10] );
+        BOOST_CHECK_EQUAL( log[sparse.offsets[i]] , '$' );
+        if (i > 0) BOOST_CHECK( sparse.times[i] > sparse.times[i - 1] );
+    }
+
+    BOOST_CHECK_THROW( buildTimeIndex(log, 0) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( CRLF )
+{
+    const std::string log = contentsOf(LogFiles::NMEALogsDir + "gga_rmc-1.log");
+    std::string crlfLog;
+    for (char c : log)
+    {
+        if (c == '\n') crlfLog += '\r';
+        crlfLog += c;
+    }
+
+    const TimeIndex index = buildTimeIndex(log, 4);
+    const TimeIndex crlfIndex = buildTimeIndex(crlfLog, 4);
+    BOOST_REQUIRE( ! crlfIndex.times.empty() );
+    BOOST_CHECK( crlfIndex.times == index.times );
+    for (std::uint64_t offset : crlfIndex.offsets) BOOST_CHECK_EQUAL( crlfLog[offset] , '$' );
+}
+
+BOOST_AUTO_TEST_CASE( ByteRange )
+{
+    TimeIndex index;
+    index.times = { 100, 200, 300 };
+    index.offsets = { 10, 20, 30 };
+
+    BOOST_CHECK( index.byteRange(0, 50, 40) == std::make_pair(std::uint64_t(0), std::uint64_t(10)) );
+    BOOST_CHECK( index.byteRange(150, 250, 40) == std::make_pair(std::uint64_t(10), std::uint64_t(30)) );
+    BOOST_CHECK( index.byteRange(200, 200, 40) == std::make_pair(std::uint64_t(20), std::uint64_t(30)) );
+    BOOST_CHECK( index.byteRange(250, 1000, 40) == std::make_pair(std::uint64_t(20), std::uint64_t(40)) );
+    BOOST_CHECK( index.byteRange(300, 100, 40).first == index.byteRange(300, 100, 40).second );
+}
+
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    TimeIndex index = buildTimeIndex(contentsOf(LogFiles::NMEALogsDir + "gga_rmc-2.log"), 5);
+    index.sourceKey = sourceKeyOf(LogFiles::NMEALogsDir + "gga_rmc-2.log");
+
+    const std::string indexPath = (tempDir / "timeIndex-tests.timeidx").string();
+    writeTimeIndex(indexPath, index);
+    const TimeIndex read = readTimeIndex(indexPath);
+
+    BOOST_CHECK_EQUAL( read.epochsPerEntry , 5u );
+    BOOST_CHECK( read.sourceKey == index.sourceKey );
+    BOOST_CHECK( read.times == index.times );
+    BOOST_CHECK( read.offsets == index.offsets );
+
+    std::filesystem::resize_file(indexPath, std::filesystem::file_size(indexPath) - 8);
+    BOOST_CHECK_THROW( readTimeIndex(indexPath) , std::domain_error );
+    std::filesystem::remove(indexPath);
+
+    BOOST_CHECK_THROW( readTimeIndex(LogFiles::NMEALogsDir + "gll.log") , std::domain_error );
+    BOOST_CHECK_THROW( readTimeIndex(LogFiles::NMEALogsDir + "nonexistent.timeidx") , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( Query )
+{
+    for (const std::string filename : { "gll.log", "gga_rmc-1.log", "gga_rmc-2.log" })
+    {
+        const std::string log = contentsOf(LogFiles::NMEALogsDir + filename);
+        const std::string logPath = temporaryLog("timeIndex-tests-" + std::string(filename), log);
+
+        PositionBatch all(true);
+        positionsFromBufferInto(log, all);
+        const double first = all.timeStamps().front();
+        const double last = all.timeStamps().back();
+
+        for (double fraction : { 0.0, 0.1, 0.5, 0.9 })
+        {
+            const double from = first + fraction * (last - first);
+            const double to = from + 10 * 60;
+            checkSamePositions(positionsBetween(logPath, from, to), expectedBetween(log, from, to));
+        }
+        BOOST_CHECK( std::filesystem::exists(timeIndexPathFor(logPath)) );
+
+        checkSamePositions(positionsBetween(logPath, 0, 24 * 60 * 60), expectedBetween(log, 0, 24 * 60 * 60));
+        BOOST_CHECK( positionsBetween(logPath, last + 1, last + 100).empty() );
+
+        removeLog(logPath);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( StaleIndexRebuilt )
+{
+    const std::string log = contentsOf(LogFiles::NMEALogsDir + "gll.log");
+    const std::string logPath = temporaryLog("timeIndex-tests-stale.log", log);
+
+    // 23:00:00, after all the other sentences.
+    const double lateTime = 23 * 60 * 60;
+    BOOST_CHECK( positionsBetween(logPath, lateTime, lateTime).empty() );
+
+    std::ofstream{logPath, std::ios::app} << "$GPGLL,5425.32,N,107.11,W,230000*55\n";
+    const PositionBatch late = positionsBetween(logPath, lateTime, lateTime);
+    BOOST_REQUIRE_EQUAL( late.size() , 1u );
+    BOOST_CHECK( readTimeIndex(timeIndexPathFor(logPath)).sourceKey == sourceKeyOf(logPath) );
+
+    removeLog(logPath);
+}
+
+BOOST_AUTO_TEST_CASE( AcrossMidnight )
+{
+    std::string log;
+    for (int second = 50; second < 70; ++second)
+    {
+        // From 23:59:50 to 00:00:09.
+        const int time = (second < 60) ? 235900 + second : second - 60;
+        char body[64];
+        std::snprintf(body, sizeof(body), "GPGLL,5425.%02d,N,107.11,W,%06d", second, time);
+        unsigned char checksum = 0;
+        for (const char * c = body; *c != '\0'; ++c) checksum ^= static_cast<unsigned char>(*c);
+        char sentence[80];
+        std::snprintf(sentence, sizeof(sentence), "$%s*%02X\n", body, checksum);
+        log += sentence;
+    }
+    const std::string logPath = temporaryLog("timeIndex-tests-midnight.log", log);
+
+    const TimeIndex index = buildTimeIndex(log, 3);
+    BOOST_CHECK_EQUAL( index.times.back() , 24 * 60 * 60 + 8 );
+
+    // 00:00:02 to 00:00:05 on the second day.
+    const PositionBatch afterMidnight = positionsBetween(logPath, 24 * 60 * 60 + 2, 24 * 60 * 60 + 5);
+    BOOST_REQUIRE_EQUAL( afterMidnight.size() , 4u );
+    BOOST_CHECK_EQUAL( afterMidnight.timeStamps().front() , 2 );
+
+    // 23:59:58 to 00:00:01.
+    BOOST_CHECK_EQUAL( positionsBetween(logPath, 24 * 60 * 60 - 2, 24 * 60 * 60 + 1).size() , 4u );
+
+    removeLog(logPath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "logs.h"
+#include "parseNMEA.h"
+#include "track.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+BOOST_AUTO_TEST_SUITE( TrackPointsFromLog )
+
+void checkDateTime(const std::tm & dateTime, int year, int month, int day, int hour, int min, int sec)
+{
+    BOOST_CHECK_EQUAL( dateTime.tm_year + 1900 , year );
+    BOOST_CHECK_EQUAL( dateTime.tm_mon + 1 , month );
+    BOOST_CHECK_EQUAL( dateTime.tm_mday , day );
+    BOOST_CHECK_EQUAL( dateTime.tm_hour , hour );
+    BOOST_CHECK_EQUAL( dateTime.tm_min , min );
+    BOOST_CHECK_EQUAL( dateTime.tm_sec , sec );
+}
+
+BOOST_AUTO_TEST_CASE( DateOf )
+{
+    SentenceView view;
+    BOOST_REQUIRE( scanSentence("$GPRMC,094627.000,A,3723.1622,N,00559.5788,W,0.000,0.00,150914,,A*6F", view) == SentenceStatus::ok );
+    const std::optional<std::tm> date = dateOf(view);
+    BOOST_REQUIRE( date );
+    checkDateTime(*date, 2014, 9, 15, 0, 0, 0);
+
+    BOOST_REQUIRE( scanSentence("$GPGGA,094627.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*7A", view) == SentenceStatus::ok );
+    BOOST_CHECK( ! dateOf(view) );
+}
+
+BOOST_AUTO_TEST_CASE( LogFile )
+{
+    const std::vector<TrackPoint> points = trackPointsFromLog(LogFiles::NMEALogsDir + "gga_rmc-1.log");
+
+    // Every GGA and RMC sentence in the log is valid.
+    BOOST_REQUIRE_EQUAL( points.size() , 632u );
+    checkDateTime(points.front().dateTime, 2014, 9, 15, 9, 46, 27);
+    checkDateTime(points.back().dateTime, 2014, 9, 15, 12, 3, 26);
+    BOOST_CHECK_EQUAL( points.front().position.latitude() , positionsFromLog(LogFiles::NMEALogsDir + "gga_rmc-1.log").front().latitude() );
+
+    const Track track(points);
+    BOOST_CHECK_EQUAL( track.totalTime().count() , (12*3600 + 3*60 + 26) - (9*3600 + 46*60 + 27) );
+}
+
+BOOST_AUTO_TEST_CASE( AcrossMidnight )
+{
+    std::stringstream log;
+    log << "$GPGGA,235959.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*75\n"  // before the first date
+        << "$GPRMC,235959.000,A,3723.1622,N,00559.5788,W,0.000,0.00,311214,,A*6C\n"
+        << "$GPGGA,000001.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*75\n"  // the next day...
+        << "$GPGLL,3723.1622,N,00559.5788,W,000002.5,A*28\n";                   // ...and year
+
+    const std::vector<TrackPoint> points = trackPointsFromLog(log);
+
+    BOOST_REQUIRE_EQUAL( points.size() , 4u );
+    checkDateTime(points[0].dateTime, 2014, 12, 31, 23, 59, 59);
+    checkDateTime(points[1].dateTime, 2014, 12, 31, 23, 59, 59);
+    checkDateTime(points[2].dateTime, 2015, 1, 1, 0, 0, 1);
+    checkDateTime(points[3].dateTime, 2015, 1, 1, 0, 0, 2);
+}
+
+BOOST_AUTO_TEST_CASE( BackToLeapDay )
+{
+    std::stringstream log;
+    log << "$GPRMC,000001.000,A,3723.1622,N,00559.5788,W,0.000,0.00,010316,,A*6D\n"
+        << "$GPGGA,235959.000,3723.1622,N,00559.5788,W,1,0,,30.0,M,,M,,*75\n";  // the previous day
+
+    const std::vector<TrackPoint> points = trackPointsFromLog(log);
+
+    BOOST_REQUIRE_EQUAL( points.size() , 2u );
+    checkDateTime(points[0].dateTime, 2016, 3, 1, 0, 0, 1);
+    checkDateTime(points[1].dateTime, 2016, 2, 29, 23, 59, 59);
+    BOOST_CHECK_EQUAL( points[1].dateTime.tm_wday , 1 ); // a Monday
+    BOOST_CHECK_EQUAL( points[1].dateTime.tm_yday , 59 );
+}
+
+BOOST_AUTO_TEST_CASE( NoDate )
+{
+    BOOST_CHECK_THROW( trackPointsFromLog(LogFiles::NMEALogsDir + "gll.log") , std::domain_error );
+
+    std::stringstream emptyLog;
+    BOOST_CHECK( trackPointsFromLog(emptyLog).empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <filesystem>
+#include <fstream>
+
+#include "logs.h"
+#include "parseNMEA.h"
+
+using namespace GPS;
+using namespace NMEA;
+
+/* tryInterpretSentenceData() must accept exactly the sentences that
+ * interpretSentenceData() accepts, with the same results, and report the reason
+ * for rejecting the others.
+ */
+
+BOOST_AUTO_TEST_SUITE( TryInterpretSentenceData )
+
+const metres absoluteTolerance = 0.0001;
+
+BOOST_AUTO_TEST_CASE( ValidSentence )
+{
+    const InterpretResult result = tryInterpretSentenceData(SentenceData{"GGA", {"170834","4124.8963","N","08151.6838","W","1","05","1.5","280.2","M","-34.0","M","",""}});
+
+    BOOST_REQUIRE( result.hasValue() );
+    BOOST_CHECK_CLOSE( result->latitude() , 41.41494 , absoluteTolerance );
+    BOOST_CHECK_CLOSE( result->longitude() , -81.86140 , absoluteTolerance );
+    BOOST_CHECK_CLOSE( result->elevation() , 280.2 , absoluteTolerance );
+}
+
+BOOST_AUTO_TEST_CASE( UnsupportedFormat )
+{
+    const InterpretResult result = tryInterpretSentenceData(SentenceData{"ZDA", {"5425.31","N","107.03","W","82610"}});
+
+    BOOST_REQUIRE( ! result );
+    BOOST_CHECK( result.error() == InterpretError::unsupportedFormat );
+    BOOST_CHECK_THROW( result.value() , std::logic_error );
+}
+
+BOOST_AUTO_TEST_CASE( MissingFields )
+{
+    const InterpretResult result = tryInterpretSentenceData(SentenceData{"GLL", {"5425.31","N","107.03"}});
+
+    BOOST_REQUIRE( ! result );
+    BOOST_CHECK( result.error() == InterpretError::missingFields );
+}
+
+BOOST_AUTO_TEST_CASE( InvalidFields )
+{
+    const std::vector<SentenceData> invalidSentences = {
+        {"GLL", {"5425.31","X","107.03","W","82610"}},
+        {"GLL", {"5425.31","NN","107.03","W","82610"}},
+        {"GLL", {"5425.31","N","107.03","","82610"}},
+        {"GLL", {"54x25.31","N","107.03","W","82610"}},
+        {"GLL", {"","N","107.03","W","82610"}},
+        {"GLL", {"-5425.31","N","107.03","W","82610"}},
+        {"GLL", {"9425.31","N","107.03","W","82610"}},
+        {"GLL", {"5425.31","N","18107.03","W","82610"}},
+        {"GGA", {"170834","4124.8963","N","08151.6838","W","1","05","1.5","high","M","-34.0","M","",""}}
+    };
+    for (const SentenceData & sentence : invalidSentences)
+    {
+        const InterpretResult result = tryInterpretSentenceData(sentence);
+
+        BOOST_REQUIRE( ! result );
+        BOOST_CHECK( result.error() == InterpretError::invalidFields );
+        BOOST_CHECK_THROW( interpretSentenceData(sentence) , std::invalid_argument );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( AgreesWithInterpretSentenceData )
+{
+    unsigned int numSentences = 0;
+    for (const std::filesystem::directory_entry & entry : std::filesystem::directory_iterator(LogFiles::NMEALogsDir))
+    {
+        std::ifstream log{entry.path()};
+        std::string line;
+        SentenceView view;
+        while (std::getline(log, line))
+        {
+            if (scanSentence(line, view) != SentenceStatus::ok) continue;
+            ++numSentences;
+
+            const InterpretResult result = tryInterpretSentenceData(view);
+            if (result)
+            {
+                const Position position = interpretSentenceData(view);
+                BOOST_CHECK_EQUAL( result->latitude() , position.latitude() );
+                BOOST_CHECK_EQUAL( result->longitude() , position.longitude() );
+                BOOST_CHECK_EQUAL( result->elevation() , position.elevation() );
+            }
+            else
+            {
+                BOOST_CHECK_THROW( interpretSentenceData(view) , std::invalid_argument );
+            }
+        }
+    }
+    BOOST_CHECK( numSentences > 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
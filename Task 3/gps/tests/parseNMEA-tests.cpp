@@ -577,6 +577,25 @@ BOOST_AUTO_TEST_CASE( LogWithTwoValidSentences )
     BOOST_CHECK_CLOSE( positions[1].longitude() , rmcPos.longitude() , percentageAccuracy );
 }
 
+BOOST_AUTO_TEST_CASE( LogWithCRLFLineBreaks )
+{
+    // NMEA 0183 receivers end each sentence with "\r\n"; the last line also lacks a line break.
+    const std::string log = validGLLSentence + "\r\n" + validRMCSentence + "\r\n\r\n" + validGLLSentence + "\r";
+
+    const unsigned int expectedSize = 3;
+
+    std::stringstream logStream(log);
+    std::vector<Position> positions = positionsFromLog(logStream);
+
+    BOOST_REQUIRE_EQUAL( positions.size() , expectedSize );
+
+    BOOST_CHECK_CLOSE( positions[0].latitude() , gllPos.latitude() , percentageAccuracy );
+    BOOST_CHECK_CLOSE( positions[1].latitude() , rmcPos.latitude() , percentageAccuracy );
+    BOOST_CHECK_CLOSE( positions[2].longitude() , gllPos.longitude() , percentageAccuracy );
+
+    BOOST_CHECK_EQUAL( positionsFromBuffer(log).size() , expectedSize );
+}
+
 BOOST_AUTO_TEST_CASE( LogWithBlankLines )
 {
     std::stringstream log;
@@ -0,0 +1,247 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "types.h"
+#include "geometry.h"
+#include "points.h"
+#include "route.h"
+#include "batchDistance.h"
+
+using namespace GPS;
+
+/* The scalar kernel must give exactly the same distances as Position::horizontalDistanceBetween(),
+ * and the SIMD kernels must stay within the error bounds documented in batchDistance.h.
+ *
+ * The SIMD kernels process whole vectors of pairs and hand the remainder over to the scalar
+ * kernel, so every batch size up to a few vectors is tested, to cover each length of tail.
+ *
+ * The pairs are chosen from three (seeded) random distributions: points anywhere on the
+ * globe, short hops typical of a GPS log, and nearly antipodal points, where asin() is
+ * ill-conditioned.
+ */
+
+BOOST_AUTO_TEST_SUITE( BatchDistance_kernels )
+
+const metres antipodalThreshold = 19000000;
+const double relativeErrorBound = 5e-13;
+const metres antipodalErrorBound = 0.01;
+
+struct Pairs
+{
+    std::vector<degrees> lat1, lon1, lat2, lon2;
+};
+
+Pairs randomPairs(std::size_t n, unsigned int seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<degrees> latitude(-90, 90);
+    std::uniform_real_distribution<degrees> longitude(-180, 180);
+    std::uniform_real_distribution<degrees> offset(-0.01, 0.01);
+
+    Pairs pairs;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const degrees lat = latitude(generator);
+        const degrees lon = longitude(generator);
+        pairs.lat1.push_back(lat);
+        pairs.lon1.push_back(lon);
+        switch (i % 3)
+        {
+          case 0: // anywhere
+            pairs.lat2.push_back(latitude(generator));
+            pairs.lon2.push_back(longitude(generator));
+            break;
+          case 1: // a short hop
+            pairs.lat2.push_back(std::max(-90.0, std::min(90.0, lat + offset(generator))));
+            pairs.lon2.push_back(normaliseDeg(lon + offset(generator)));
+            break;
+          default: // nearly antipodal
+            pairs.lat2.push_back(std::max(-90.0, std::min(90.0, -lat + offset(generator))));
+            pairs.lon2.push_back(normaliseDeg(lon + 180 + offset(generator)));
+            break;
+        }
+    }
+    return pairs;
+}
+
+std::vector<metres> distancesUsing(const BatchDistance::Kernels & kernels, const Pairs & pairs)
+{
+    std::vector<metres> distances(pairs.lat1.size());
+    kernels.pairwise(pairs.lat1.data(), pairs.lon1.data(), pairs.lat2.data(), pairs.lon2.data(),
+                     distances.data(), distances.size());
+    return distances;
+}
+
+void checkWithinErrorBound(metres actual, metres expected)
+{
+    if (expected > antipodalThreshold)
+    {
+        BOOST_CHECK_SMALL( actual - expected , antipodalErrorBound );
+    }
+    else
+    {
+        // Points at the same pole have a tiny non-zero distance, so allow for rounding there.
+        BOOST_CHECK_SMALL( actual - expected , std::max(expected * relativeErrorBound, 1e-15) );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ScalarKernelsAvailable )
+{
+    const std::vector<const BatchDistance::Kernels *> kernels = BatchDistance::availableKernels();
+
+    BOOST_REQUIRE( ! kernels.empty() );
+    BOOST_CHECK_EQUAL( kernels.front() , &BatchDistance::scalarKernels() );
+    BOOST_CHECK_EQUAL( kernels.back() , &BatchDistance::bestKernels() );
+}
+
+BOOST_AUTO_TEST_CASE( ScalarMatchesHorizontalDistanceBetween )
+{
+    const Pairs pairs = randomPairs(3000, 1);
+    const std::vector<metres> distances = distancesUsing(BatchDistance::scalarKernels(), pairs);
+
+    for (std::size_t i = 0; i < distances.size(); ++i)
+    {
+        const metres expected = Position::horizontalDistanceBetween(Position(pairs.lat1[i], pairs.lon1[i]),
+                                                                    Position(pairs.lat2[i], pairs.lon2[i]));
+        BOOST_CHECK_EQUAL( distances[i] , expected );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( KernelsWithinErrorBound )
+{
+    const Pairs pairs = randomPairs(30000, 2);
+    const std::vector<metres> expected = distancesUsing(BatchDistance::scalarKernels(), pairs);
+
+    for (const BatchDistance::Kernels * kernels : BatchDistance::availableKernels())
+    {
+        BOOST_TEST_CONTEXT( kernels->name )
+        {
+            const std::vector<metres> actual = distancesUsing(*kernels, pairs);
+            for (std::size_t i = 0; i < expected.size(); ++i)
+            {
+                checkWithinErrorBound(actual[i], expected[i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( AllTailLengths )
+{
+    const Pairs pairs = randomPairs(20, 3);
+    const std::vector<metres> expected = distancesUsing(BatchDistance::scalarKernels(), pairs);
+
+    for (const BatchDistance::Kernels * kernels : BatchDistance::availableKernels())
+    {
+        for (std::size_t n = 0; n <= expected.size(); ++n)
+        {
+            BOOST_TEST_CONTEXT( kernels->name << " with " << n << " pairs" )
+            {
+                std::vector<metres> actual(expected.size(), -1);
+                kernels->pairwise(pairs.lat1.data(), pairs.lon1.data(), pairs.lat2.data(), pairs.lon2.data(),
+                                  actual.data(), n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    checkWithinErrorBound(actual[i], expected[i]);
+                }
+                for (std::size_t i = n; i < actual.size(); ++i)
+                {
+                    BOOST_CHECK_EQUAL( actual[i] , -1 ); // nothing written beyond the batch
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( SpecialPoints )
+{
+    // Coincident points, poles, and points either side of the anti-meridian.
+    const Pairs pairs = { { 0, 90, -90, 90, 10, 45 },
+                          { 0, 0, 0, 0, 179.5, 45 },
+                          { 0, 90, 90, -90, 10, 45 },
+                          { 0, 120, 0, 0, -179.5, 45 } };
+    const std::vector<metres> expected = distancesUsing(BatchDistance::scalarKernels(), pairs);
+
+    for (const BatchDistance::Kernels * kernels : BatchDistance::availableKernels())
+    {
+        BOOST_TEST_CONTEXT( kernels->name )
+        {
+            const std::vector<metres> actual = distancesUsing(*kernels, pairs);
+            BOOST_CHECK_EQUAL( actual[0] , 0 );
+            BOOST_CHECK_EQUAL( actual[5] , 0 );
+            for (std::size_t i = 0; i < expected.size(); ++i)
+            {
+                checkWithinErrorBound(actual[i], expected[i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( ConsecutivePositions )
+{
+    const std::vector<Position> positions = { Position(20,2), Position(30,3), Position(40,4), Position(40,4),
+                                              Position(-10,170), Position(-10,-170) };
+
+    const std::vector<metres> distances = BatchDistance::consecutiveDistances(positions);
+
+    BOOST_REQUIRE_EQUAL( distances.size() , positions.size() - 1 );
+    for (std::size_t i = 0; i < distances.size(); ++i)
+    {
+        checkWithinErrorBound(distances[i], Position::horizontalDistanceBetween(positions[i], positions[i+1]));
+    }
+
+    BOOST_CHECK( BatchDistance::consecutiveDistances(std::vector<Position>{}).empty() );
+    BOOST_CHECK( BatchDistance::consecutiveDistances(std::vector<Position>{ Position(0,0) }).empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* Route::totalLength() and the gradient functions compute their horizontal distances as a batch,
+ * so they should agree with a leg-by-leg calculation to within the batch error bound.
+ */
+
+BOOST_AUTO_TEST_SUITE( Route_batchDistances )
+
+const double percentageTolerance = 1e-10;
+
+BOOST_AUTO_TEST_CASE( MatchesLegByLeg )
+{
+    std::vector<RoutePoint> routePoints;
+    for (int i = 0; i < 23; ++i)
+    {
+        routePoints.push_back({ Position(50 + 0.001 * i * i, -1 + 0.002 * i, 10 * (i % 5)), "" });
+    }
+    const Route route {routePoints};
+
+    metres expectedLength = 0;
+    degrees expectedMaxGradient = -90;
+    for (std::size_t i = 0; i + 1 < routePoints.size(); ++i)
+    {
+        const Position & current = routePoints[i].position;
+        const Position & next = routePoints[i+1].position;
+        const metres deltaH = Position::horizontalDistanceBetween(current, next);
+        const metres deltaV = next.elevation() - current.elevation();
+        expectedLength += std::sqrt(deltaH*deltaH + deltaV*deltaV);
+        expectedMaxGradient = std::max(expectedMaxGradient, std::atan(deltaV/deltaH) * 180 / 3.141592653589793);
+    }
+
+    BOOST_CHECK_CLOSE( route.totalLength() , expectedLength , percentageTolerance );
+    BOOST_CHECK_CLOSE( route.maxGradient() , expectedMaxGradient , percentageTolerance );
+}
+
+BOOST_AUTO_TEST_CASE( SinglePoint )
+{
+    const Route route {{ { Position(50,-1), "P1" } }};
+
+    BOOST_CHECK_EQUAL( route.totalLength() , 0 );
+    BOOST_CHECK_THROW( route.maxGradient() , std::domain_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,43 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include "types.h"
+#include "geometry.h"
+#include "position.h"
+#include "earth.h"
+
+using namespace GPS;
+
+/* The geometry and Earth constants, the named Positions, and the conversions between them are
+ * constexpr, so are checked at compile time with static_assert.  The Position constructor must
+ * still validate its arguments when called at run-time.
+ */
+
+BOOST_AUTO_TEST_SUITE( Position_constexpr )
+
+static_assert( halfRotation == 180 );
+static_assert( degToRad(halfRotation) == pi );
+static_assert( radToDeg(pi / 2) == poleLatitude );
+static_assert( Earth::NorthPole.latitude() == poleLatitude );
+static_assert( Earth::EquatorialAntiMeridian.longitude() == antiMeridianLongitude );
+static_assert( Earth::CliftonCampus.elevation() == 58 );
+static_assert( Earth::latitudeSubtendedBy(Earth::polarCircumference / 4) == poleLatitude );
+
+constexpr Position constantPosition(-45, 90, 10);
+static_assert( degToRad(constantPosition.longitude()) == pi / 2 );
+
+BOOST_AUTO_TEST_CASE( RuntimeValidation )
+{
+    volatile degrees lat = 90.5;
+    volatile degrees lon = -180.5;
+
+    BOOST_CHECK_THROW( Position(lat, 0) , std::invalid_argument );
+    BOOST_CHECK_THROW( Position(-lat, 0) , std::invalid_argument );
+    BOOST_CHECK_THROW( Position(0, lon) , std::invalid_argument );
+    BOOST_CHECK_THROW( Position(0, -lon) , std::invalid_argument );
+    BOOST_CHECK_NO_THROW( Position(poleLatitude, antiMeridianLongitude) );
+    BOOST_CHECK_NO_THROW( Position(-poleLatitude, -antiMeridianLongitude) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,200 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "types.h"
+#include "points.h"
+#include "route.h"
+#include "track.h"
+#include "distanceModel.h"
+
+using namespace GPS;
+
+/* Each DistanceModel is checked against known distances, and the approximate models against
+ * the error bounds documented in distanceModel.h.
+ *
+ * Routes and Tracks must then use their model for all horizontal distances, which is checked
+ * by comparing a Route built with each model against a leg-by-leg calculation.
+ */
+
+BOOST_AUTO_TEST_SUITE( DistanceModel_models )
+
+metres distanceUsing(const DistanceModel & model, Position p1, Position p2)
+{
+    return model.horizontalDistanceBetween(PreparedPosition(p1), PreparedPosition(p2));
+}
+
+degrees dms(degrees d, degrees m, degrees s)
+{
+    return d + m / 60 + s / 3600;
+}
+
+BOOST_AUTO_TEST_CASE( Names )
+{
+    BOOST_CHECK_EQUAL( DistanceModels::haversine().name , std::string("haversine") );
+    BOOST_CHECK_EQUAL( DistanceModels::equirectangular().name , std::string("equirectangular") );
+    BOOST_CHECK_EQUAL( DistanceModels::flatEarth().name , std::string("flat earth") );
+    BOOST_CHECK_EQUAL( DistanceModels::vincenty().name , std::string("Vincenty") );
+}
+
+BOOST_AUTO_TEST_CASE( HaversineSameAsPosition )
+{
+    const Position p1(52.91249953,-1.18402513);
+    const Position p2(-33.9,151.2);
+
+    BOOST_CHECK_EQUAL( distanceUsing(DistanceModels::haversine(), p1, p2) , Position::horizontalDistanceBetween(p1,p2) );
+    BOOST_CHECK( DistanceModels::haversine().horizontalDistances != nullptr );
+}
+
+BOOST_AUTO_TEST_CASE( VincentyKnownDistances )
+{
+    // Flinders Peak to Buninyong, the example in Vincenty's paper.
+    const Position flindersPeak(-dms(37,57,3.72030), dms(144,25,29.52440));
+    const Position buninyong(-dms(37,39,10.15610), dms(143,55,35.38390));
+    BOOST_CHECK_SMALL( distanceUsing(DistanceModels::vincenty(), flindersPeak, buninyong) - 54972.271 , 0.001 );
+
+    // One degree along the equator, and a quarter meridian.
+    BOOST_CHECK_SMALL( distanceUsing(DistanceModels::vincenty(), Position(0,0), Position(0,1)) - 111319.491 , 0.001 );
+    BOOST_CHECK_SMALL( distanceUsing(DistanceModels::vincenty(), Position(0,0), Position(90,0)) - 10001965.729 , 0.001 );
+
+    BOOST_CHECK_EQUAL( distanceUsing(DistanceModels::vincenty(), flindersPeak, flindersPeak) , 0 );
+}
+
+BOOST_AUTO_TEST_CASE( VincentyNearlyAntipodal )
+{
+    // The iteration does not converge, so the haversine distance is used.
+    const Position p1(0,0), p2(0.5,179.7);
+    BOOST_CHECK_EQUAL( distanceUsing(DistanceModels::vincenty(), p1, p2) , distanceUsing(DistanceModels::haversine(), p1, p2) );
+
+    const Route route {{ {p1, "Here"}, {p2, "There"} }, DistanceModels::vincenty()};
+    BOOST_CHECK_EQUAL( route.totalLength() , distanceUsing(DistanceModels::haversine(), p1, p2) );
+}
+
+BOOST_AUTO_TEST_CASE( HaversineWithinEllipsoidBound )
+{
+    const std::vector<Position> positions = { Position(0,0), Position(52.9,-1.2), Position(-33.9,151.2),
+                                              Position(89,45), Position(-60,-70), Position(10,100) };
+    for (const Position & p1 : positions)
+    {
+        for (const Position & p2 : positions)
+        {
+            const metres ellipsoidal = distanceUsing(DistanceModels::vincenty(), p1, p2);
+            BOOST_CHECK_SMALL( distanceUsing(DistanceModels::haversine(), p1, p2) - ellipsoidal , ellipsoidal * 0.006 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( ApproximationsWithinBounds )
+{
+    const std::vector<Position> starts = { Position(0,0), Position(52.9,-1.2), Position(-79.9,20), Position(45,179.99) };
+
+    for (const Position & start : starts)
+    {
+        for (metres north : { -7000.0, 0.0, 100.0, 5000.0 })
+        {
+            for (metres east : { -7000.0, 0.0, 3.0, 6000.0 })
+            {
+                const degrees lat = std::max(-80.0, start.latitude() + north / 111000);
+                degrees lon = start.longitude() + east / (111000 * std::cos(start.latitude() * 3.141592653589793 / 180));
+                if (lon > 180) lon -= 360;
+                const Position end(lat, lon);
+
+                const metres expected = distanceUsing(DistanceModels::haversine(), start, end);
+                BOOST_CHECK_SMALL( distanceUsing(DistanceModels::equirectangular(), start, end) - expected , expected * 0.00001 );
+                BOOST_CHECK_SMALL( distanceUsing(DistanceModels::flatEarth(), start, end) - expected , expected * 0.002 );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( DistanceModel_routes )
+
+const double percentageTolerance = 1e-10;
+
+const std::vector<const DistanceModel *> models = { &DistanceModels::haversine(), &DistanceModels::equirectangular(),
+                                                    &DistanceModels::flatEarth(), &DistanceModels::vincenty() };
+
+std::vector<RoutePoint> walk()
+{
+    std::vector<RoutePoint> routePoints;
+    for (int i = 0; i < 12; ++i)
+    {
+        routePoints.push_back({ Position(52.9 + 0.0003 * i, -1.2 + 0.0005 * (i % 4), 5.0 * (i % 3)), "P" + std::to_string(i) });
+    }
+    return routePoints;
+}
+
+BOOST_AUTO_TEST_CASE( RoutesUseTheirModel )
+{
+    const std::vector<RoutePoint> routePoints = walk();
+
+    for (const DistanceModel * model : models)
+    {
+        BOOST_TEST_CONTEXT( model->name )
+        {
+            const Route route {routePoints, *model};
+            BOOST_CHECK_EQUAL( &route.distanceModel() , model );
+
+            metres expectedLength = 0;
+            for (std::size_t i = 0; i + 1 < routePoints.size(); ++i)
+            {
+                const Position & current = routePoints[i].position;
+                const Position & next = routePoints[i+1].position;
+                const metres deltaH = model->horizontalDistanceBetween(PreparedPosition(current), PreparedPosition(next));
+                const metres deltaV = next.elevation() - current.elevation();
+                expectedLength += std::sqrt(deltaH*deltaH + deltaV*deltaV);
+            }
+            BOOST_CHECK_CLOSE( route.totalLength() , expectedLength , percentageTolerance );
+
+            const Position & start = routePoints.front().position;
+            const Position & finish = routePoints.back().position;
+            const metres netH = model->horizontalDistanceBetween(PreparedPosition(start), PreparedPosition(finish));
+            const metres netV = finish.elevation() - start.elevation();
+            BOOST_CHECK_CLOSE( route.netLength() , std::sqrt(netH*netH + netV*netV) , percentageTolerance );
+
+            BOOST_CHECK_EQUAL( route.nearestPointTo(Position(52.90301,-1.19898)).name , "P10" );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( DefaultIsHaversine )
+{
+    const Route route {walk()};
+    BOOST_CHECK_EQUAL( &route.distanceModel() , &DistanceModels::haversine() );
+}
+
+BOOST_AUTO_TEST_CASE( TracksUseTheirModel )
+{
+    std::vector<TrackPoint> trackPoints;
+    int seconds = 0;
+    for (const RoutePoint & routePoint : walk())
+    {
+        std::tm dateTime = {};
+        dateTime.tm_year = 2026 - 1900;
+        dateTime.tm_mday = 1;
+        dateTime.tm_sec = seconds;
+        seconds += 10;
+        trackPoints.push_back({ routePoint.position, routePoint.name, dateTime });
+    }
+
+    for (const DistanceModel * model : models)
+    {
+        BOOST_TEST_CONTEXT( model->name )
+        {
+            const Track track {trackPoints, 10, *model};
+            BOOST_CHECK_EQUAL( &track.distanceModel() , model );
+            BOOST_CHECK_EQUAL( track.numPoints() , trackPoints.size() );
+            BOOST_CHECK_EQUAL( track.timesVisited(trackPoints[3].position) , 1u );
+            BOOST_CHECK_CLOSE( track.averageSpeed(true) , track.totalLength() / (10 * (trackPoints.size() - 1)) , percentageTolerance );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <ctime>
+#include <vector>
+
+#include "types.h"
+#include "geometry.h"
+#include "points.h"
+#include "route.h"
+#include "track.h"
+
+using namespace GPS;
+
+/* PreparedPosition must give exactly the same distances as Position::horizontalDistanceBetween(),
+ * since it is used in place of it by the one-to-many queries of Route and Track.
+ *
+ * The Route and Track queries that use their stored PreparedPositions are tested on a small
+ * route, including after a Track has merged points (which changes the route points, so the
+ * prepared copies must be rebuilt to stay in step).
+ */
+
+BOOST_AUTO_TEST_SUITE( PreparedPosition_distances )
+
+const std::vector<Position> positions = { Position(0,0), Position(51.5,-0.1), Position(-33.9,151.2),
+                                          Position(90,0), Position(-90,45), Position(10,179.9),
+                                          Position(10,-179.9), Position(51.5001,-0.1001) };
+
+BOOST_AUTO_TEST_CASE( CachedValues )
+{
+    const PreparedPosition prepared(Position(60,-30,100));
+
+    BOOST_CHECK_EQUAL( prepared.position().latitude() , 60 );
+    BOOST_CHECK_EQUAL( prepared.position().longitude() , -30 );
+    BOOST_CHECK_EQUAL( prepared.position().elevation() , 100 );
+    BOOST_CHECK_EQUAL( prepared.latitudeRadians() , degToRad(60) );
+    BOOST_CHECK_EQUAL( prepared.longitudeRadians() , degToRad(-30) );
+    BOOST_CHECK_EQUAL( prepared.cosLatitude() , Trig::cos<trigPrecision>(degToRad(60)) );
+}
+
+BOOST_AUTO_TEST_CASE( SameAsPositionDistances )
+{
+    for (const Position & p1 : positions)
+    {
+        for (const Position & p2 : positions)
+        {
+            const metres expected = Position::horizontalDistanceBetween(p1,p2);
+            BOOST_CHECK_EQUAL( PreparedPosition::horizontalDistanceBetween(PreparedPosition(p1), PreparedPosition(p2)) , expected );
+            BOOST_CHECK_EQUAL( PreparedPosition::horizontalDistanceBetween(PreparedPosition(p1), p2) , expected );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( PreparedPosition_routeQueries )
+
+const RoutePoint london = { Position(51.5074,-0.1278), "London" };
+const RoutePoint paris = { Position(48.8566,2.3522), "Paris" };
+const RoutePoint rome = { Position(41.9028,12.4964), "Rome" };
+const RoutePoint madrid = { Position(40.4168,-3.7038), "Madrid" };
+
+TrackPoint trackPoint(RoutePoint routePoint, int minutes)
+{
+    std::tm dateTime = {};
+    dateTime.tm_year = 2026 - 1900;
+    dateTime.tm_mon = 9;
+    dateTime.tm_mday = 16;
+    dateTime.tm_hour = 12;
+    dateTime.tm_min = minutes;
+    return { routePoint.position, routePoint.name, dateTime };
+}
+
+BOOST_AUTO_TEST_CASE( NearestAndFarthest )
+{
+    const Route route {{ london, paris, rome, madrid }};
+
+    BOOST_CHECK_EQUAL( route.nearestPointTo(Position(48,2)).name , "Paris" );
+    BOOST_CHECK_EQUAL( route.nearestPointTo(rome.position).name , "Rome" );
+    BOOST_CHECK_EQUAL( route.farthestPointFrom(london.position).name , "Rome" );
+    BOOST_CHECK_EQUAL( route.farthestPointFrom(Position(42,13)).name , "London" );
+}
+
+BOOST_AUTO_TEST_CASE( TrackQueries )
+{
+    // The second point is within the granularity of the first, so is merged.
+    const RoutePoint nearLondon = { Position(51.50745,-0.12785), "Near London" };
+    const Track track {{ trackPoint(london,0), trackPoint(nearLondon,1), trackPoint(paris,2),
+                         trackPoint(rome,3), trackPoint(london,4) }};
+
+    BOOST_REQUIRE_EQUAL( track.numPoints() , 4u );
+    BOOST_CHECK_EQUAL( track.timesVisited(london.position) , 2u );
+    BOOST_CHECK_EQUAL( track.timesVisited(madrid.position) , 0u );
+    BOOST_CHECK_EQUAL( track.findNameOf(nearLondon.position) , "London" );
+    BOOST_CHECK_EQUAL( track.nearestPointTo(Position(41,12)).name , "Rome" );
+    BOOST_CHECK_EQUAL( track.farthestPointFrom(Position(41,12)).name , "London" );
+    BOOST_CHECK( track.containsCycles() );
+
+    const Track noCycles {{ trackPoint(london,0), trackPoint(paris,1), trackPoint(rome,2) }};
+    BOOST_CHECK( ! noCycles.containsCycles() );
+}
+
+BOOST_AUTO_TEST_CASE( AfterSetGranularity )
+{
+    Track track {{ trackPoint(london,0), trackPoint(paris,1), trackPoint(rome,2) }};
+    BOOST_REQUIRE_EQUAL( track.numPoints() , 3u );
+
+    // London and Paris are about 344 km apart, so are merged with a 400 km granularity.
+    track.setGranularity(400000);
+    BOOST_REQUIRE_EQUAL( track.numPoints() , 2u );
+    BOOST_CHECK_EQUAL( track.nearestPointTo(paris.position).name , "London" );
+    BOOST_CHECK_EQUAL( track.nearestPointTo(rome.position).name , "Rome" );
+    BOOST_CHECK_EQUAL( track.timesVisited(paris.position) , 1u );
+
+    // The batched leg lengths use the merged points too.
+    BOOST_CHECK_CLOSE( track.totalLength() , Position::horizontalDistanceBetween(london.position, rome.position) , 1e-9 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "types.h"
+#include "geometry.h"
+
+using namespace GPS;
+
+/* Each precision tier of the Trig functions is compared against the standard library over a
+ * dense grid of arguments, and must stay within the absolute error bound documented in
+ * geometry.h.  Close to zero, sin, asin and atan must also have a small relative error.
+ *
+ * sin and cos are also tested on large arguments (up to the documented 1e6), where the
+ * argument reduction is most likely to lose accuracy, and the inverse functions on the edges
+ * of their domains.
+ */
+
+BOOST_AUTO_TEST_SUITE( Trig_tiers )
+
+const double lowErrorBound = 1e-7;
+const double highErrorBound = 1e-12;
+
+std::vector<double> grid(double from, double to, unsigned int steps)
+{
+    std::vector<double> values;
+    for (unsigned int i = 0; i <= steps; ++i)
+    {
+        values.push_back(from + (to - from) * i / steps);
+    }
+    return values;
+}
+
+template <Trig::Precision P>
+void checkAgainstStandardLibrary(const std::vector<double> & sinCosArguments, double errorBound)
+{
+    for (radians x : sinCosArguments)
+    {
+        BOOST_CHECK_SMALL( Trig::sin<P>(x) - std::sin(x) , errorBound );
+        BOOST_CHECK_SMALL( Trig::cos<P>(x) - std::cos(x) , errorBound );
+    }
+    for (double x : grid(-1, 1, 20000))
+    {
+        BOOST_CHECK_SMALL( Trig::asin<P>(x) - std::asin(x) , errorBound );
+    }
+    for (double x : grid(-50, 50, 20000))
+    {
+        BOOST_CHECK_SMALL( Trig::atan<P>(x) - std::atan(x) , errorBound );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( LowPrecision )
+{
+    checkAgainstStandardLibrary<Trig::Precision::low>(grid(-10, 10, 20000), lowErrorBound);
+}
+
+BOOST_AUTO_TEST_CASE( HighPrecision )
+{
+    checkAgainstStandardLibrary<Trig::Precision::high>(grid(-10, 10, 20000), highErrorBound);
+}
+
+BOOST_AUTO_TEST_CASE( LargeArguments )
+{
+    const std::vector<double> arguments = grid(-1e6, 1e6, 20001);
+    checkAgainstStandardLibrary<Trig::Precision::low>(arguments, lowErrorBound);
+    checkAgainstStandardLibrary<Trig::Precision::high>(arguments, highErrorBound);
+}
+
+BOOST_AUTO_TEST_CASE( SmallArguments )
+{
+    for (double x : { 1e-300, 1e-20, 1e-10, -1e-8, 1e-5, -1e-3 })
+    {
+        BOOST_CHECK_CLOSE( Trig::sin<Trig::Precision::high>(x) , std::sin(x) , 1e-12 );
+        BOOST_CHECK_CLOSE( Trig::asin<Trig::Precision::high>(x) , std::asin(x) , 1e-12 );
+        BOOST_CHECK_CLOSE( Trig::atan<Trig::Precision::high>(x) , std::atan(x) , 1e-12 );
+        BOOST_CHECK_CLOSE( Trig::sin<Trig::Precision::low>(x) , std::sin(x) , 1e-7 );
+        BOOST_CHECK_CLOSE( Trig::asin<Trig::Precision::low>(x) , std::asin(x) , 1e-7 );
+        BOOST_CHECK_CLOSE( Trig::atan<Trig::Precision::low>(x) , std::atan(x) , 1e-7 );
+    }
+
+    BOOST_CHECK_EQUAL( Trig::sin<trigPrecision>(0) , 0 );
+    BOOST_CHECK_EQUAL( Trig::cos<trigPrecision>(0) , 1 );
+    BOOST_CHECK_EQUAL( Trig::asin<trigPrecision>(0) , 0 );
+    BOOST_CHECK_EQUAL( Trig::atan<trigPrecision>(0) , 0 );
+}
+
+BOOST_AUTO_TEST_CASE( DomainEdges )
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    BOOST_CHECK_EQUAL( Trig::asin<trigPrecision>(1) , pi / 2 );
+    BOOST_CHECK_EQUAL( Trig::asin<trigPrecision>(-1) , -pi / 2 );
+    BOOST_CHECK_EQUAL( Trig::atan<trigPrecision>(infinity) , pi / 2 );
+    BOOST_CHECK_EQUAL( Trig::atan<trigPrecision>(-infinity) , -pi / 2 );
+    BOOST_CHECK_SMALL( Trig::atan<trigPrecision>(1) - pi / 4 , highErrorBound );
+    BOOST_CHECK_SMALL( Trig::atan<trigPrecision>(1e300) - pi / 2 , highErrorBound );
+}
+
+BOOST_AUTO_TEST_SUITE_END()